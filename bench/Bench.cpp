@@ -0,0 +1,67 @@
+#include "Bench.hpp"
+#include <algorithm>
+#include <iostream>
+
+using namespace io::bench;
+
+namespace {
+
+void write_string(std::ostream& out, const std::string& s) {
+    out << '"';
+    for(char c : s) {
+        if(c == '"' || c == '\\')
+            out << '\\';
+        out << c;
+    }
+    out << '"';
+}
+
+}
+
+void Runner::add(Result r) {
+    std::cerr << r.name << ": " << r.value << ' ' << r.unit << std::endl;
+    results.push_back(std::move(r));
+}
+
+Result Runner::summarize(const std::string& name, std::vector<double>& per_item, uint64_t iterations) {
+    std::sort(per_item.begin(), per_item.end());
+    return {name, "ns/op", per_item[per_item.size() / 2], per_item.front(), iterations};
+}
+
+void Runner::metric(const std::string& name, const std::string& unit, double value) {
+    if(enabled(name))
+        add({name, unit, value, value, 0});
+}
+
+void Runner::ratio(const std::string& name, const std::string& a, const std::string& b) {
+    auto find = [this](const std::string& n) {
+        return std::find_if(results.begin(), results.end(), [&n](const Result& r) { return r.name == n; });
+    };
+    auto ra = find(a), rb = find(b);
+    if(ra != results.end() && rb != results.end() && rb->value > 0)
+        metric(name, "x", ra->value / rb->value);
+}
+
+void Runner::write_json(std::ostream& out) const {
+    out << "{\n  \"context\": {\n";
+    out << "    \"compiler\": ";
+    write_string(out, __VERSION__);
+#ifdef NDEBUG
+    out << ",\n    \"assertions\": false,\n";
+#else
+    out << ",\n    \"assertions\": true,\n";
+#endif
+    out << "    \"samples\": " << samples << ",\n";
+    out << "    \"min_time_ms\": " << min_time_ms << "\n  },\n";
+    out << "  \"benchmarks\": [";
+    for(size_t i = 0; i < results.size(); ++i) {
+        auto& r = results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        write_string(out, r.name);
+        out << ", \"unit\": ";
+        write_string(out, r.unit);
+        out << ", \"value\": " << r.value << ", \"min\": " << r.min
+            << ", \"iterations\": " << r.iterations << '}';
+    }
+    out << "\n  ]\n}\n";
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace io::bench {
+
+template<typename T>
+inline void do_not_optimize(const T& v) {
+    asm volatile("" : : "r,m"(v) : "memory");
+}
+
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+struct Result {
+    std::string name;
+    std::string unit;
+    double value;      // median over samples
+    double min;
+    uint64_t iterations;
+};
+
+class Runner {
+    std::vector<Result> results;
+    std::string filter;
+    double min_time_ms;
+    size_t samples;
+
+    static uint64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    void add(Result r);
+public:
+    Runner(std::string filter, double min_time_ms, size_t samples)
+        : filter(std::move(filter)), min_time_ms(min_time_ms), samples(samples) {}
+
+    bool enabled(const std::string& name) const {
+        return name.find(filter) != std::string::npos;
+    }
+
+    // Times fn(), which performs `items` operations per call, and records
+    // nanoseconds per operation. The call count is calibrated so that every
+    // sample runs for about min_time_ms / samples.
+    template<typename FN>
+    void time(const std::string& name, size_t items, FN&& fn) {
+        if(!enabled(name))
+            return;
+        auto t = now();
+        fn();
+        uint64_t once = std::max<uint64_t>(1, now() - t);
+        uint64_t calls = std::max<uint64_t>(1, static_cast<uint64_t>(
+            min_time_ms * 1e6 / samples / once));
+
+        std::vector<double> per_item;
+        for(size_t s = 0; s < samples; ++s) {
+            t = now();
+            for(uint64_t c = 0; c < calls; ++c)
+                fn();
+            per_item.push_back(double(now() - t) / (calls * items));
+        }
+        add(summarize(name, per_item, calls * items * samples));
+    }
+
+    // Records a value that is not a timing, e.g. a count.
+    void metric(const std::string& name, const std::string& unit, double value);
+    // Records the median of `a` over that of `b` when both ran, e.g. a new
+    // path's cost relative to the one it replaced.
+    void ratio(const std::string& name, const std::string& a, const std::string& b);
+
+    void write_json(std::ostream& out) const;
+private:
+    static Result summarize(const std::string& name, std::vector<double>& per_item, uint64_t iterations);
+};
+
+void run_dispatch_benches(Runner& r);
+void run_text_edit_benches(Runner& r);
+void run_utf_benches(Runner& r);
+void run_pump_benches(Runner& r);
+void run_gamepad_benches(Runner& r);
+// `replay_path`: an event log of pointer motion; empty for a generated one.
+void run_prediction_benches(Runner& r, const std::string& replay_path);
+
+}
@@ -0,0 +1,365 @@
+#include "Bench.hpp"
+#include <WindowContext/ActionMap.hpp>
+#include <WindowContext/HeadlessContext.hpp>
+#include <GLFW/glfw3.h>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+using namespace io;
+using namespace io::bench;
+
+namespace {
+
+constexpr size_t batch = 1024;
+
+std::vector<InputEvent> make_batch(EventType type) {
+    std::vector<InputEvent> v;
+    for(size_t i = 0; i < batch; ++i) {
+        switch(type) {
+        case EventType::key_input:
+            v.push_back(InputEvent::make_key_input(GLFW_KEY_A + i % 26, i % 2 ? GLFW_RELEASE : GLFW_PRESS, 0));
+            break;
+        case EventType::cursor_position:
+            v.push_back(InputEvent::make_cursor_position(i % 640, i % 480));
+            break;
+        case EventType::mouse_movement:
+            v.push_back(InputEvent::make_mouse_movement(1, -1));
+            break;
+        case EventType::mouse_input:
+            v.push_back(InputEvent::make_mouse_input(i % 3, i % 2 ? GLFW_RELEASE : GLFW_PRESS, 0));
+            break;
+        case EventType::window_resize:
+            v.push_back(InputEvent::make_window_resize(640 + i % 64, 480 + i % 64));
+            break;
+        case EventType::character:
+            v.push_back(InputEvent::make_character('a' + i % 26));
+            break;
+        case EventType::scroll_input:
+            v.push_back(InputEvent::make_scroll_input(0, 1));
+            break;
+        case EventType::gamepad_connection:
+            v.push_back(InputEvent::make_gamepad_connection(i % 16, i / 16 % 2 == 0));
+            break;
+        case EventType::gamepad_button:
+            v.push_back(InputEvent::make_gamepad_button(i % 16, i / 16 % 15, i % 2 ? GLFW_RELEASE : GLFW_PRESS));
+            break;
+        case EventType::gamepad_axis:
+            v.push_back(InputEvent::make_gamepad_axis(i % 16, i % 6, (i % 200) / 100.0f - 1.0f));
+            break;
+        default:
+            break;
+        }
+    }
+    return v;
+}
+
+// Injects a batch and drains it, i.e. producer plus consumer cost per event.
+void time_batches(Runner& r, const std::string& name, HeadlessContext& ctx,
+                  const std::vector<InputEvent>& events) {
+    r.time(name, events.size(), [&]() {
+        ctx.inject(events.data(), events.size());
+        ctx.drain_events();
+    });
+}
+
+void dispatch_per_type(Runner& r) {
+    for(size_t t = 0; t < event_type_count; ++t) {
+        auto type = static_cast<EventType>(t);
+        HeadlessContext ctx(640, 480, batch);
+        ctx.set_cursor_mode(true);
+        uint64_t seen = 0;
+        ctx.subscribe(type, [&seen](const InputEvent&) { ++seen; return false; });
+        time_batches(r, std::string("dispatch/") + event_type_name(type), ctx, make_batch(type));
+        do_not_optimize(seen);
+    }
+}
+
+// The demo's listener chain before prioritized subscriptions replaced it.
+class KeyInputListenerBase : public IKeyInputListener {
+    IKeyInputListener* next{nullptr};
+    virtual bool _serve(int key, int action, int mods) = 0;
+public:
+    void serve_key_input(int key, int action, int mods) override {
+        if(!_serve(key, action, mods) && next)
+            next->serve_key_input(key, action, mods);
+    }
+    void set_next(IKeyInputListener* il) {
+        next = il;
+    }
+};
+
+class PassThroughListener : public KeyInputListenerBase {
+    bool _serve(int key, int, int) override {
+        do_not_optimize(key);
+        return false;
+    }
+};
+
+void chain_depth(Runner& r) {
+    auto events = make_batch(EventType::key_input);
+    for(size_t depth : {1, 4, 16, 64}) {
+        std::vector<PassThroughListener> chain(depth);
+        for(size_t i = 0; i + 1 < depth; ++i)
+            chain[i].set_next(&chain[i + 1]);
+        HeadlessContext listener_ctx(640, 480, batch);
+        listener_ctx.set_key_input_listener(&chain[0]);
+        time_batches(r, "chain/listener/depth_" + std::to_string(depth), listener_ctx, events);
+
+        HeadlessContext subscribe_ctx(640, 480, batch);
+        for(size_t i = 0; i < depth; ++i)
+            subscribe_ctx.subscribe(EventType::key_input, [](const InputEvent& e) {
+                do_not_optimize(e.key.key);
+                return false;
+            }, static_cast<int>(i));
+        time_batches(r, "chain/subscribe/depth_" + std::to_string(depth), subscribe_ctx, events);
+        r.ratio("chain/subscribe_vs_listener/depth_" + std::to_string(depth),
+                "chain/subscribe/depth_" + std::to_string(depth), "chain/listener/depth_" + std::to_string(depth));
+    }
+}
+
+class KeyListener : public IKeyInputListener {
+public:
+    void serve_key_input(int key, int, int) override {
+        do_not_optimize(key);
+    }
+};
+
+class EventListener : public IInputEventListener {
+public:
+    void serve_input_event(const InputEvent& e) override {
+        do_not_optimize(e.key.key);
+    }
+};
+
+void registration(Runner& r) {
+    auto events = make_batch(EventType::key_input);
+    {
+        KeyListener l;
+        HeadlessContext ctx(640, 480, batch);
+        ctx.set_key_input_listener(&l);
+        time_batches(r, "registration/listener", ctx, events);
+    }
+    {
+        HeadlessContext ctx(640, 480, batch);
+        ctx.set_key_input_callback([](int key, int, int) { do_not_optimize(key); });
+        time_batches(r, "registration/callback", ctx, events);
+    }
+    {
+        EventListener l;
+        HeadlessContext ctx(640, 480, batch);
+        ctx.set_input_event_listener(&l);
+        time_batches(r, "registration/input_event_listener", ctx, events);
+    }
+    {
+        HeadlessContext ctx(640, 480, batch);
+        ctx.subscribe(EventType::key_input, [](const InputEvent& e) {
+            do_not_optimize(e.key.key);
+            return false;
+        });
+        time_batches(r, "registration/subscribe", ctx, events);
+    }
+}
+
+void motion_modes(Runner& r) {
+    std::vector<InputEvent> events;
+    for(size_t i = 0; i < batch; ++i)
+        events.push_back(InputEvent::make_cursor_position(320 + i % 17, 240 - i % 13));
+
+    for(bool cursor : {true, false}) {
+        HeadlessContext ctx(640, 480, batch);
+        ctx.set_cursor_mode(cursor);
+        ctx.set_cursor_position_callback([](double x, double) { do_not_optimize(x); });
+        ctx.set_mouse_movement_callback([](double x, double) { do_not_optimize(x); });
+        time_batches(r, cursor ? "motion/cursor_mode" : "motion/movement_mode", ctx, events);
+    }
+
+    // What GLFWContext pays per cursor sample with and without raw motion.
+    for(bool warp_free : {false, true}) {
+        RelativeMotion m;
+        m.set_center(640, 480);
+        m.set_warp_free(warp_free);
+        std::string name = warp_free ? "motion/relative_warp_free" : "motion/relative_warp";
+        r.time(name, events.size(), [&]() {
+            for(auto& e : events) {
+                double dx, dy;
+                bool warp;
+                m.convert(e.position.x, e.position.y, dx, dy, warp);
+                do_not_optimize(dx);
+                do_not_optimize(warp);
+            }
+        });
+        auto stats = m.stats();
+        r.metric(name + "/warps_per_1000_events", "warps",
+                 stats.motion_events ? 1000.0 * stats.warps / stats.motion_events : 0);
+    }
+}
+
+// The callback slots GLFWContext used before Delegate.
+template<typename ...Args>
+struct ICallback {
+    virtual void operator()(Args...) = 0;
+    virtual ~ICallback() = default;
+};
+
+template<typename ...Args>
+struct FunctionCallback : ICallback<Args...> {
+    std::function<void(Args...)> fn;
+    void operator()(Args... args) override { fn(args...); }
+};
+
+template<typename IFace, typename ...Args>
+struct PtrCallback : ICallback<Args...> {
+    IFace* ptr;
+    void (IFace::*fn)(Args...);
+    void operator()(Args... args) override { (*ptr.*fn)(args...); }
+};
+
+template<typename CB>
+void time_calls(Runner& r, const std::string& name, CB& cb) {
+    r.time(name, batch, [&]() {
+        for(int i = 0; i < static_cast<int>(batch); ++i) {
+            auto p = &cb;
+            do_not_optimize(p);
+            (*p)(i, 1, 0);
+        }
+    });
+}
+
+void callbacks(Runner& r) {
+    KeyListener l;
+
+    auto icb_listener = std::make_unique<PtrCallback<IKeyInputListener, int, int, int>>();
+    icb_listener->ptr = &l;
+    icb_listener->fn = &IKeyInputListener::serve_key_input;
+    ICallback<int, int, int>& icb_l = *icb_listener;
+    time_calls(r, "callback/icallback_listener", icb_l);
+
+    KeyInputCallback delegate_listener = KeyInputCallback::bind<&IKeyInputListener::serve_key_input>(
+        static_cast<IKeyInputListener*>(&l));
+    time_calls(r, "callback/delegate_listener", delegate_listener);
+
+    auto lambda = [](int key, int, int) { do_not_optimize(key); };
+    auto icb_function = std::make_unique<FunctionCallback<int, int, int>>();
+    icb_function->fn = lambda;
+    ICallback<int, int, int>& icb_f = *icb_function;
+    time_calls(r, "callback/icallback_function", icb_f);
+
+    KeyInputCallback delegate_lambda = lambda;
+    time_calls(r, "callback/delegate_lambda", delegate_lambda);
+
+    std::function<void(int, int, int)> function = lambda;
+    time_calls(r, "callback/std_function", function);
+}
+
+// Cost on the dispatching threads per event; executor handlers run later on
+// the pool, so this is the price of posting to a serial queue.
+void affinities(Runner& r) {
+    std::pair<const char*, ListenerAffinity> cases[] = {
+        {"inline", ListenerAffinity::inline_},
+        {"main_thread", ListenerAffinity::main_thread},
+        {"executor", ListenerAffinity::executor},
+    };
+    auto events = make_batch(EventType::key_input);
+    for(auto [name, affinity] : cases) {
+        auto full_name = std::string("dispatch/affinity/") + name;
+        if(!r.enabled(full_name))
+            continue;
+        // Declared first: the context waits for the pool when destroyed.
+        std::atomic<uint64_t> seen{0};
+        HeadlessContext ctx(640, 480, batch);
+        ctx.subscribe(EventType::key_input, [&seen](const InputEvent&) {
+            seen.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }, 0, affinity);
+        time_batches(r, full_name, ctx, events);
+    }
+}
+
+// An input proxy wanting three of 26 keys: checking in the handler against
+// a subscription filter, and a type nobody listens to.
+void filters(Runner& r) {
+    auto events = make_batch(EventType::key_input);
+    uint64_t seen = 0;
+    auto wanted = [](int key) { return key == GLFW_KEY_W || key == GLFW_KEY_A || key == GLFW_KEY_D; };
+    {
+        HeadlessContext ctx(640, 480, batch);
+        ctx.subscribe(EventType::key_input, [&](const InputEvent& e) {
+            if(wanted(e.key.key) && e.key.action == GLFW_PRESS)
+                ++seen;
+            return false;
+        });
+        time_batches(r, "dispatch/filter/in_handler", ctx, events);
+    }
+    {
+        HeadlessContext ctx(640, 480, batch);
+        for(int key : {GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_D})
+            ctx.subscribe(EventType::key_input, [&seen](const InputEvent&) { ++seen; return false; },
+                          0, ListenerAffinity::main_thread, EventFilter::code(key, EventFilter::on_press));
+        time_batches(r, "dispatch/filter/subscription", ctx, events);
+    }
+    {
+        HeadlessContext ctx(640, 480, batch);
+        ctx.subscribe(EventType::scroll_input, [&seen](const InputEvent&) { ++seen; return false; });
+        time_batches(r, "dispatch/filter/unwanted_type", ctx, events);
+    }
+    do_not_optimize(seen);
+}
+
+void action_lookup(Runner& r) {
+    std::vector<InputEvent> events;
+    uint32_t s = 1;
+    for(size_t i = 0; i < batch; ++i) {
+        s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+        events.push_back(InputEvent::make_key_input(GLFW_KEY_A + s % 64, s / 64 % 3, 0));
+    }
+
+    // The demo's binding table before ActionMap.
+    auto hash = [](int key, int action, int mods) {
+        size_t h = key;
+        h <<= 16;
+        h |= action;
+        h <<= 16;
+        h |= mods;
+        return h;
+    };
+    uint64_t fired = 0;
+    std::unordered_map<size_t, std::function<void()>> map;
+    ActionMap actions;
+    for(int k = 0; k < 16; ++k) {
+        map[hash(GLFW_KEY_A + k * 4, GLFW_PRESS, 0)] = [&fired]() { ++fired; };
+        actions.bind(GLFW_KEY_A + k * 4, ActionMap::on_press, k);
+    }
+    std::vector<std::function<void()>> fns(16, [&fired]() { ++fired; });
+
+    r.time("actions/unordered_map", events.size(), [&]() {
+        for(auto& e : events)
+            if(auto it = map.find(hash(e.key.key, e.key.action, e.key.mods)); it != map.end())
+                it->second();
+    });
+    r.time("actions/action_map", events.size(), [&]() {
+        for(auto& e : events)
+            actions.process(e, [&fns](ActionId id, int) { fns[id](); });
+    });
+    r.ratio("actions/action_map_vs_unordered_map", "actions/action_map", "actions/unordered_map");
+    do_not_optimize(fired);
+}
+
+}
+
+// Per event costs of injecting and draining through a HeadlessContext, and
+// of the pieces around it. The *_vs_* ratios compare each replacement with
+// what it replaced: chain/subscribe_vs_listener/depth_N prioritized
+// subscriptions against the demo's listener chain, and
+// actions/action_map_vs_unordered_map ActionMap against the demo's binding
+// table; below 1 is faster.
+void io::bench::run_dispatch_benches(Runner& r) {
+    dispatch_per_type(r);
+    chain_depth(r);
+    registration(r);
+    motion_modes(r);
+    callbacks(r);
+    affinities(r);
+    filters(r);
+    action_lookup(r);
+}
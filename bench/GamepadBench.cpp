@@ -0,0 +1,67 @@
+#include "Bench.hpp"
+#include <WindowContext/Gamepad.hpp>
+#include <WindowContext/HeadlessContext.hpp>
+
+using namespace io;
+using namespace io::bench;
+
+namespace {
+
+constexpr size_t pads = GamepadReadings::pad_count;
+constexpr size_t axes = GamepadReadings::axis_count;
+
+// Every pad connected, every axis somewhere past the deadzone; `phase`
+// moves all of them.
+GamepadReadings make_readings(float phase) {
+    GamepadReadings r;
+    for(size_t pad = 0; pad < pads; ++pad) {
+        float values[axes];
+        for(size_t a = 0; a < axes; ++a)
+            values[a] = 0.3f + 0.01f * (pad + a) + phase;
+        r.set(static_cast<int>(pad), 0x5555, values);
+    }
+    return r;
+}
+
+}
+
+// Per pad polled: filtering and diffing when nothing moved (the usual
+// case), and when every axis moved and is emitted. Then the cost per event
+// of a headless pass: poll, queue, track state, dispatch.
+void io::bench::run_gamepad_benches(Runner& r) {
+    GamepadReadings still = make_readings(0.0f);
+    GamepadReadings moved[2] = {make_readings(0.1f), make_readings(0.2f)};
+
+    {
+        GamepadPoller poller;
+        uint64_t events = 0;
+        auto count = [&events](const InputEvent&) { ++events; };
+        poller.update(still, 1, count);
+        r.time("gamepad/poll/unchanged", pads, [&]() {
+            poller.update(still, 1, count);
+        });
+        size_t i = 0;
+        r.time("gamepad/poll/all_axes_moved", pads, [&]() {
+            poller.update(moved[i++ & 1], 1, count);
+        });
+        do_not_optimize(events);
+    }
+
+    HeadlessContext ctx;
+    ctx.set_frame_interval(0);
+    ctx.set_state_tracking(true);
+    uint64_t seen = 0;
+    ctx.subscribe(EventType::gamepad_axis, [&seen](const InputEvent&) { ++seen; return false; });
+    std::array<float, axes> values;
+    size_t i = 0;
+    r.time("gamepad/headless/axis_event", pads * axes, [&]() {
+        float phase = 0.1f * (1 + (i++ & 1));
+        for(size_t pad = 0; pad < pads; ++pad) {
+            for(size_t a = 0; a < axes; ++a)
+                values[a] = 0.3f + 0.01f * (pad + a) + phase;
+            ctx.set_gamepad(static_cast<int>(pad), 0, values);
+        }
+        ctx.update();
+    });
+    do_not_optimize(seen);
+}
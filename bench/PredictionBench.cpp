@@ -0,0 +1,152 @@
+#include "Bench.hpp"
+#include <WindowContext/EventLog.hpp>
+#include <WindowContext/MotionPredictor.hpp>
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+
+using namespace io;
+using namespace io::bench;
+
+namespace {
+
+struct Point {
+    uint64_t t;
+    double x, y;
+};
+
+// Reaching movements between random targets with a minimum-jerk profile and
+// pauses in between, sampled at about 1 kHz in whole pixels as a mouse
+// reports them.
+void record_synthetic(const std::string& path) {
+    std::mt19937 rng(7);
+    auto uniform = [&rng](double lo, double hi) { return std::uniform_real_distribution<double>(lo, hi)(rng); };
+    EventRecorder recorder(path);
+    uint64_t t = 1'000'000'000;
+    double x = 640, y = 360;
+    for(int move = 0; move < 80; ++move) {
+        double tx = uniform(100, 1180), ty = uniform(100, 620);
+        double duration = uniform(0.15, 0.6);
+        uint64_t start = t;
+        for(double s = 0; s < 1;) {
+            t += static_cast<uint64_t>(uniform(0.9e6, 1.1e6));
+            s = std::min(1.0, (t - start) * 1e-9 / duration);
+            double k = s * s * s * (10 - 15 * s + 6 * s * s);
+            auto e = InputEvent::make_cursor_position(std::round(x + (tx - x) * k), std::round(y + (ty - y) * k));
+            e.timestamp = t;
+            recorder.record(e);
+        }
+        x = tx;
+        y = ty;
+        t += static_cast<uint64_t>(uniform(0, 200e6));
+    }
+}
+
+// Cursor positions as recorded, relative motion summed into positions.
+std::vector<Point> load(const std::string& path) {
+    EventLogReader reader(path);
+    std::vector<Point> points;
+    double mx = 0, my = 0;
+    InputEvent e;
+    while(reader.next(e)) {
+        if(e.type == EventType::cursor_position) {
+            points.push_back({e.timestamp, e.position.x, e.position.y});
+        } else if(e.type == EventType::mouse_movement) {
+            mx += e.position.x;
+            my += e.position.y;
+            points.push_back({e.timestamp, mx, my});
+        }
+    }
+    return points;
+}
+
+// Position at `t` from the samples at and after points[i]: interpolated
+// while moving, held across a pause.
+Point truth(const std::vector<Point>& points, size_t& i, uint64_t t) {
+    while(i + 1 < points.size() && points[i + 1].t <= t)
+        ++i;
+    auto& a = points[i];
+    if(i + 1 == points.size() || points[i + 1].t - a.t > 10'000'000)
+        return a;
+    auto& b = points[i + 1];
+    double k = double(t - a.t) / double(b.t - a.t);
+    return {t, a.x + (b.x - a.x) * k, a.y + (b.y - a.y) * k};
+}
+
+void measure(Runner& r, const std::string& name, const std::vector<Point>& points,
+             const PredictionConfig* config, uint64_t horizon) {
+    MotionPredictor predictor(config ? *config : PredictionConfig{});
+    std::vector<double> errors;
+    size_t j = 0;
+    for(auto& p : points) {
+        predictor.add(p.t, p.x, p.y);
+        uint64_t target = p.t + horizon;
+        if(target > points.back().t)
+            break;
+        auto [px, py] = config ? predictor.estimate().predict(target) : std::tuple<double, double>{p.x, p.y};
+        auto real = truth(points, j, target);
+        errors.push_back(std::hypot(px - real.x, py - real.y));
+    }
+    if(errors.empty())
+        return;
+    double sum = 0;
+    for(double e : errors)
+        sum += e * e;
+    std::sort(errors.begin(), errors.end());
+    r.metric(name + "/rmse", "px", std::sqrt(sum / errors.size()));
+    r.metric(name + "/p99", "px", errors[errors.size() * 99 / 100]);
+}
+
+}
+
+// Replays a log of cursor or relative motion, by default a generated one,
+// and compares each filter's prediction a fixed horizon past every sample
+// with where the pointer really was; "none" is the latest sample, i.e. no
+// prediction. Then the cost of feeding a sample and of predicting.
+void io::bench::run_prediction_benches(Runner& r, const std::string& replay_path) {
+    if(!r.enabled("prediction/"))
+        return;
+    auto path = replay_path;
+    if(path.empty()) {
+        path = (std::filesystem::temp_directory_path() / "io_bench_cursor.log").string();
+        record_synthetic(path);
+    }
+    auto points = load(path);
+    if(replay_path.empty())
+        std::filesystem::remove(path);
+    if(points.size() < 2)
+        return;
+
+    PredictionConfig one_euro, linear_fit;
+    linear_fit.filter = PredictionFilter::linear_fit;
+    const std::pair<const char*, const PredictionConfig*> filters[] = {
+        {"none", nullptr}, {"one_euro", &one_euro}, {"linear_fit", &linear_fit}};
+    for(uint64_t ms : {8, 16}) {
+        for(auto [filter, config] : filters) {
+            auto name = std::string("prediction/") + filter + "/" + std::to_string(ms) + "ms";
+            if(r.enabled(name))
+                measure(r, name, points, config, ms * 1'000'000);
+        }
+    }
+
+    for(auto [filter, config] : filters) {
+        if(!config)
+            continue;
+        MotionPredictor predictor(*config);
+        r.time(std::string("prediction/") + filter + "/add", points.size(), [&]() {
+            predictor.reset();
+            for(auto& p : points)
+                predictor.add(p.t, p.x, p.y);
+        });
+    }
+    MotionPredictor predictor;
+    for(auto& p : points)
+        predictor.add(p.t, p.x, p.y);
+    uint64_t i = 0;
+    r.time("prediction/predict", 1, [&]() {
+        auto [x, y] = predictor.estimate().predict(points.back().t + (++i & 0xfffff));
+        do_not_optimize(x);
+        do_not_optimize(y);
+    });
+}
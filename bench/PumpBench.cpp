@@ -0,0 +1,40 @@
+#include "Bench.hpp"
+#include <WindowContext/LatencyHistogram.hpp>
+#include <WindowContext/Waker.hpp>
+#include <atomic>
+#include <thread>
+
+using namespace io;
+using namespace io::bench;
+
+// The handoff PumpMode::thread adds on top of the OS wakeup: the pump thread
+// notifies, update() returns from its wait. Notifications are spaced out so
+// the consumer is asleep each time, as it is between input events.
+void io::bench::run_pump_benches(Runner& r) {
+    const std::string name = "pump/wake_latency";
+    if(!r.enabled(name))
+        return;
+
+    Waker waker;
+    LatencyHistogram histogram;
+    std::atomic<uint64_t> sent{0};
+    std::atomic_bool done{false};
+    std::thread consumer([&]() {
+        while(waker.wait_until(0) && !done)
+            histogram.record(monotonic_ns() - sent.load(std::memory_order_acquire));
+    });
+    for(int i = 0; i < 2000; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        sent.store(monotonic_ns(), std::memory_order_release);
+        waker.notify();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    done = true;
+    waker.notify();
+    consumer.join();
+
+    auto p = histogram.percentiles();
+    r.metric(name + "/p50", "ns", double(p.p50));
+    r.metric(name + "/p99", "ns", double(p.p99));
+    r.metric(name + "/max", "ns", double(p.max));
+}
@@ -0,0 +1,186 @@
+#include "Bench.hpp"
+#include <Text/TerminalTextRenderer.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+#include <list>
+#include <streambuf>
+#include <Text/Utf.hpp>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+using namespace io;
+using namespace io::bench;
+
+namespace {
+
+// One codepoint at a time, as the demo did through icu::UnicodeString.
+template<typename It>
+std::string get_str(It begin, It end) {
+    std::string str;
+    std::for_each(begin, end, [&str](uint32_t c){ append_utf8(str, &c, 1); });
+    return str;
+}
+
+std::string get_str(const uint32_t* begin, const uint32_t* end) {
+    std::string str;
+    append_utf8(str, begin, end - begin);
+    return str;
+}
+
+// The demo's TextEdit storage and printing, writing to any stream.
+class ListTextEdit {
+    std::list<uint32_t> characters;
+    std::list<uint32_t>::iterator cursor{characters.end()};
+public:
+    void insert(uint32_t codepoint) {
+        characters.insert(cursor, codepoint);
+    }
+    void backspace() {
+        if(cursor == characters.begin()) return;
+        cursor = characters.erase(std::prev(cursor));
+    }
+    bool move_left() {
+        if(cursor == characters.begin())
+            return false;
+        --cursor;
+        return true;
+    }
+    bool move_right() {
+        if(cursor == characters.end())
+            return false;
+        ++cursor;
+        return true;
+    }
+    void print(std::ostream& out) {
+        out << get_str(characters.begin(), cursor);
+        if(cursor == characters.end()) {
+            out << "\u001b[7m \u001b[0m" << std::endl;
+            return;
+        }
+        out << "\u001b[7m" << get_str(cursor, std::next(cursor)) << "\u001b[0m";
+        out << get_str(std::next(cursor), characters.end()) << std::endl;
+    }
+};
+
+// The TextEdit demo printing over the gap buffer's two halves.
+void print(const TextEdit& te, std::ostream& out) {
+    auto before = te.before_cursor();
+    auto after = te.after_cursor();
+    auto after_end = after + te.after_cursor_size();
+    out << get_str(before, before + te.before_cursor_size());
+    if(after == after_end) {
+        out << "\u001b[7m \u001b[0m" << std::endl;
+        return;
+    }
+    out << "\u001b[7m" << get_str(after, after + 1) << "\u001b[0m";
+    out << get_str(after + 1, after_end) << std::endl;
+}
+
+uint32_t sample_char(size_t i) {
+    // Mixed scripts so printing exercises multi-byte UTF-8.
+    return i % 4 == 3 ? 0x0436 : 'a' + i % 26;
+}
+
+size_t heap_in_use() {
+#ifdef __GLIBC__
+    return mallinfo2().uordblks;
+#else
+    return 0;
+#endif
+}
+
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        return n;
+    }
+};
+
+template<typename Edit, typename Print>
+void edit_benches(Runner& r, const std::string& prefix, size_t size, Print&& print_fn) {
+    auto suffix = "/" + std::to_string(size);
+    bool any = false;
+    for(auto name : {"bytes_per_char", "insert", "move", "print"})
+        any |= r.enabled(prefix + name + suffix);
+    if(!any)
+        return;
+
+    auto heap = heap_in_use();
+    auto te = std::make_unique<Edit>();
+    for(size_t i = 0; i < size; ++i)
+        te->insert(sample_char(i));
+    if(heap)
+        r.metric(prefix + "bytes_per_char" + suffix, "bytes",
+                 double(heap_in_use() - heap) / size);
+    for(size_t i = 0; i < size / 2; ++i)
+        te->move_left();
+
+    r.time(prefix + "insert" + suffix, 1, [&]() {
+        te->insert('x');
+        te->backspace();
+    });
+    r.time(prefix + "move" + suffix, 64, [&]() {
+        for(int i = 0; i < 32; ++i)
+            te->move_left();
+        for(int i = 0; i < 32; ++i)
+            te->move_right();
+    });
+    r.time(prefix + "print" + suffix, 1, [&]() {
+        print_fn(*te);
+    });
+}
+
+}
+
+void io::bench::run_text_edit_benches(Runner& r) {
+    NullBuffer null_buffer;
+    std::ostream null_out(&null_buffer);
+
+    for(size_t size : {1000, 100000, 1000000}) {
+        edit_benches<ListTextEdit>(r, "text_edit/list/", size, [&](ListTextEdit& te) { te.print(null_out); });
+        edit_benches<TextEdit>(r, "text_edit/gap/", size, [&](TextEdit& te) { print(te, null_out); });
+    }
+
+    // A keystroke plus the frame drawing it, incremental against the full
+    // re-encode and print the demo did per keystroke.
+    int null_fd = ::open("/dev/null", O_WRONLY);
+    for(size_t size : {1000, 100000, 1000000}) {
+        auto name = "text_edit/render/keystroke/" + std::to_string(size);
+        if(!r.enabled(name))
+            continue;
+        TextEdit te;
+        for(size_t i = 0; i < size; ++i)
+            te.insert(sample_char(i));
+        for(size_t i = 0; i < size / 2; ++i)
+            te.move_left();
+        TerminalTextRenderer renderer(null_fd);
+        renderer.render(te);
+        r.time(name, 2, [&]() {
+            te.insert('x');
+            renderer.render(te);
+            te.backspace();
+            renderer.render(te);
+        });
+    }
+    ::close(null_fd);
+
+    // Pasting a large log: per character into the list, one bulk insert into the gap buffer.
+    std::vector<uint32_t> paste(65536);
+    for(size_t i = 0; i < paste.size(); ++i)
+        paste[i] = sample_char(i);
+    r.time("text_edit/list/paste_64k", paste.size(), [&]() {
+        ListTextEdit te;
+        for(auto c : paste)
+            te.insert(c);
+        do_not_optimize(te);
+    });
+    r.time("text_edit/gap/paste_64k", paste.size(), [&]() {
+        TextEdit te;
+        te.insert(paste.data(), paste.size());
+        do_not_optimize(te);
+    });
+}
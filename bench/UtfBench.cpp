@@ -0,0 +1,74 @@
+#include "Bench.hpp"
+#include <Text/TextEdit.hpp>
+#include <Text/Utf.hpp>
+#include <vector>
+
+using namespace io;
+using namespace io::bench;
+
+namespace {
+
+constexpr size_t text_size = 1 << 20;
+
+// Log-like ASCII, Cyrillic mixed with ASCII, and all three-byte CJK.
+std::vector<uint32_t> make_text(const std::string& kind) {
+    std::vector<uint32_t> v(text_size);
+    for(size_t i = 0; i < v.size(); ++i) {
+        if(kind == "ascii")
+            v[i] = i % 64 == 63 ? '\n' : ' ' + i % 95;
+        else if(kind == "mixed")
+            v[i] = i % 4 == 3 ? ' ' : 0x0430 + i % 32;
+        else
+            v[i] = 0x4e00 + i % 2048;
+    }
+    return v;
+}
+
+const char* path_name(UtfPath path) {
+    switch(path) {
+    case UtfPath::scalar: return "scalar";
+    case UtfPath::sse2: return "sse2";
+    case UtfPath::avx2: return "avx2";
+    }
+    return "unknown";
+}
+
+}
+
+// encode: ns per codepoint; decode and validate: ns per byte.
+void io::bench::run_utf_benches(Runner& r) {
+    auto best = get_utf_path();
+    for(std::string kind : {"ascii", "mixed", "cjk"}) {
+        auto text = make_text(kind);
+        std::string utf8;
+        append_utf8(utf8, text.data(), text.size());
+        std::vector<char> encoded(max_utf8_size(text.size()));
+        std::vector<uint32_t> decoded(utf8.size());
+
+        for(auto path : {UtfPath::scalar, UtfPath::sse2, UtfPath::avx2}) {
+            set_utf_path(path);
+            if(get_utf_path() != path)
+                continue;
+            auto suffix = "/" + kind + "/" + path_name(path);
+            r.time("utf/encode" + suffix, text.size(), [&]() {
+                do_not_optimize(utf32_to_utf8(text.data(), text.size(), encoded.data()));
+                clobber_memory();
+            });
+            r.time("utf/decode" + suffix, utf8.size(), [&]() {
+                do_not_optimize(utf8_to_utf32(utf8.data(), utf8.size(), decoded.data()));
+                clobber_memory();
+            });
+            r.time("utf/validate" + suffix, utf8.size(), [&]() {
+                do_not_optimize(validate_utf8(utf8.data(), utf8.size()));
+            });
+        }
+        set_utf_path(best);
+
+        // Pasting the whole text into the console, per byte pasted.
+        r.time("text_edit/gap/paste_utf8/" + kind, utf8.size(), [&]() {
+            TextEdit te;
+            te.insert_utf8(utf8);
+            do_not_optimize(te);
+        });
+    }
+}
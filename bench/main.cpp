@@ -0,0 +1,52 @@
+#include "Bench.hpp"
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+using namespace io::bench;
+
+// io_bench [--filter SUBSTRING] [--min-time MS] [--samples N] [--out FILE]
+//          [--replay EVENT_LOG]
+// Progress goes to stderr; the JSON report to stdout or FILE.
+int main(int argc, char** argv) {
+    std::string filter, out_path, replay_path;
+    double min_time_ms = 200;
+    size_t samples = 5;
+    for(int i = 1; i < argc; ++i) {
+        auto arg = [&]() -> std::string {
+            if(i + 1 >= argc)
+                throw std::invalid_argument(std::string("Missing value for ") + argv[i]);
+            return argv[++i];
+        };
+        if(!std::strcmp(argv[i], "--filter"))
+            filter = arg();
+        else if(!std::strcmp(argv[i], "--min-time"))
+            min_time_ms = std::stod(arg());
+        else if(!std::strcmp(argv[i], "--samples"))
+            samples = std::max(1, std::stoi(arg()));
+        else if(!std::strcmp(argv[i], "--out"))
+            out_path = arg();
+        else if(!std::strcmp(argv[i], "--replay"))
+            replay_path = arg();
+        else
+            throw std::invalid_argument(std::string("Unknown argument ") + argv[i]);
+    }
+
+    Runner r(filter, min_time_ms, samples);
+    run_dispatch_benches(r);
+    run_text_edit_benches(r);
+    run_utf_benches(r);
+    run_pump_benches(r);
+    run_gamepad_benches(r);
+    run_prediction_benches(r, replay_path);
+
+    if(out_path.empty()) {
+        r.write_json(std::cout);
+    } else {
+        std::ofstream out(out_path);
+        if(!out)
+            throw std::runtime_error("Couldn't open " + out_path);
+        r.write_json(out);
+    }
+}
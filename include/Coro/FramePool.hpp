@@ -0,0 +1,43 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace io {
+
+// Free lists of coroutine frames by power-of-two size class, one pool per
+// thread. A flow that finishes and starts again every frame reuses the
+// frames of the previous run; only frames above the largest class always
+// come from the heap. A frame freed on another thread joins that thread's
+// pool.
+class FramePool {
+public:
+    static constexpr size_t min_size = 64;
+    static constexpr size_t class_count = 7;  // 64 B to 4 KiB
+private:
+    struct Block {
+        Block* next;
+    };
+
+    std::array<Block*, class_count> free_lists{};
+    uint64_t heap_allocations{0};
+
+    static size_t size_class(size_t n);
+public:
+    FramePool() = default;
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+    ~FramePool();
+
+    static FramePool& local();
+
+    void* allocate(size_t n);
+    void deallocate(void* p, size_t n);
+
+    // Frames this pool had to take from the heap so far.
+    uint64_t get_heap_allocations() const {
+        return heap_allocations;
+    }
+};
+
+}
@@ -0,0 +1,133 @@
+#pragma once
+#include "Task.hpp"
+#include <WindowContext/IWindowContext.hpp>
+#include <string>
+#include <vector>
+
+namespace io {
+
+// Resumes coroutines waiting for input from handlers it subscribes on `ctx`
+// and from a drain callback it adds, so they run on the consumer thread during
+// update(). Events that resume a waiter are consumed at `priority`.
+// Waiting allocates nothing: awaiters live in the coroutine frame and are
+// linked into the scheduler's lists.
+class InputScheduler {
+    struct Link {
+        Link* prev{this};
+        Link* next{this};
+
+        Link() = default;
+        Link(const Link&) = delete;
+        Link& operator=(const Link&) = delete;
+        ~Link() {
+            unlink();
+        }
+        bool linked() const {
+            return next != this;
+        }
+        void unlink() {
+            prev->next = next;
+            next->prev = prev;
+            prev = next = this;
+        }
+        // Links `l` before this one, i.e. at the back of a list headed here.
+        void push_back(Link* l) {
+            l->unlink();
+            l->prev = prev;
+            l->next = this;
+            prev->next = l;
+            prev = l;
+        }
+    };
+public:
+    class KeyAwaiter : Link {
+        friend class InputScheduler;
+    protected:
+        InputScheduler& scheduler;
+        EventFilter filter;
+        uint64_t deadline{0};
+        std::optional<KeyEvent> result;
+        std::coroutine_handle<> handle;
+
+        KeyAwaiter(InputScheduler& scheduler, const EventFilter& filter, uint64_t timeout_ns = 0);
+        ~KeyAwaiter();
+    public:
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> h);
+    };
+    struct NextKeyAwaiter : KeyAwaiter {
+        using KeyAwaiter::KeyAwaiter;
+        KeyEvent await_resume() {
+            return *result;
+        }
+    };
+    // Empty on timeout.
+    struct AnyOfAwaiter : KeyAwaiter {
+        using KeyAwaiter::KeyAwaiter;
+        std::optional<KeyEvent> await_resume() {
+            return result;
+        }
+    };
+    // The line typed until Enter, or empty when cancelled with Escape.
+    class TextLineAwaiter : Link {
+        friend class InputScheduler;
+        InputScheduler& scheduler;
+        std::string text;
+        bool cancelled{false};
+        std::coroutine_handle<> handle;
+
+        explicit TextLineAwaiter(InputScheduler& scheduler) : scheduler(scheduler) {}
+    public:
+        bool await_ready() const noexcept {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> h);
+        std::optional<std::string> await_resume() {
+            if(cancelled)
+                return std::nullopt;
+            return std::move(text);
+        }
+    };
+private:
+    IWindowContext& ctx;
+    SubscriptionToken key_token, character_token;
+    uint64_t drain_id;
+    Link key_waiters, text_waiters;
+    size_t timed_waiters{0};
+    std::vector<std::coroutine_handle<>> roots;
+    std::exception_ptr failure;
+
+    void resume(std::coroutine_handle<> h);
+    void resume_all(Link& ready);
+    bool on_key(const InputEvent& e);
+    bool on_character(const InputEvent& e);
+    void on_drain();
+    static void root_done(void* self, std::coroutine_handle<> h, std::exception_ptr e);
+public:
+    explicit InputScheduler(IWindowContext& ctx, int priority = 100);
+    InputScheduler(const InputScheduler&) = delete;
+    InputScheduler& operator=(const InputScheduler&) = delete;
+    // Destroys the tasks still suspended.
+    ~InputScheduler();
+
+    // Runs `task` until its first suspension; an exception escaping it is
+    // rethrown from the update() that resumed it.
+    void spawn(Task<> task);
+    size_t get_task_count() const {
+        return roots.size();
+    }
+
+    NextKeyAwaiter next_key(const EventFilter& filter = EventFilter::any(EventFilter::on_press));
+    // Whichever comes first: a key event matching `filter` or the timeout.
+    AnyOfAwaiter any_of(const EventFilter& filter, uint64_t timeout_ns);
+    AnyOfAwaiter any_of(int key, uint64_t timeout_ns) {
+        return any_of(EventFilter::code(key, EventFilter::on_press), timeout_ns);
+    }
+    // Collects characters, with Backspace, until Enter or Escape. Only the
+    // oldest text_line() receives input.
+    TextLineAwaiter text_line();
+};
+
+}
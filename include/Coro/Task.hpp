@@ -0,0 +1,132 @@
+#pragma once
+#include "FramePool.hpp"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace io {
+
+namespace detail {
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+    // Set for tasks without an awaiting coroutine, e.g. by InputScheduler.
+    void (*on_done)(void* ctx, std::coroutine_handle<> h, std::exception_ptr e){nullptr};
+    void* done_ctx{nullptr};
+
+    static void* operator new(size_t n) {
+        return FramePool::local().allocate(n);
+    }
+    static void operator delete(void* p, size_t n) {
+        FramePool::local().deallocate(p, n);
+    }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept {
+            return false;
+        }
+        template<typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept {
+            auto& p = h.promise();
+            if(p.continuation)
+                return p.continuation;
+            if(p.on_done)
+                p.on_done(p.done_ctx, h, p.exception);
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept {
+        return {};
+    }
+    FinalAwaiter final_suspend() noexcept {
+        return {};
+    }
+    void unhandled_exception() {
+        exception = std::current_exception();
+    }
+};
+
+template<typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    template<typename U>
+    void return_value(U&& v) {
+        value.emplace(std::forward<U>(v));
+    }
+    T take() {
+        if(exception)
+            std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template<>
+struct Promise<void> : PromiseBase {
+    void return_void() {}
+    void take() {
+        if(exception)
+            std::rethrow_exception(exception);
+    }
+};
+
+}
+
+// Lazily started coroutine returning T. Awaiting it runs it to completion
+// and resumes the awaiting coroutine directly; frames come from FramePool.
+template<typename T = void>
+class [[nodiscard]] Task {
+public:
+    struct promise_type : detail::Promise<T> {
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+private:
+    Handle h;
+
+    explicit Task(Handle h) : h(h) {}
+public:
+    Task(Task&& o) noexcept : h(std::exchange(o.h, nullptr)) {}
+    Task& operator=(Task&& o) noexcept {
+        if(this != &o) {
+            if(h)
+                h.destroy();
+            h = std::exchange(o.h, nullptr);
+        }
+        return *this;
+    }
+    ~Task() {
+        if(h)
+            h.destroy();
+    }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Handle h;
+            bool await_ready() noexcept {
+                return false;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                h.promise().continuation = awaiting;
+                return h;
+            }
+            T await_resume() {
+                return h.promise().take();
+            }
+        };
+        return Awaiter{h};
+    }
+
+    // Gives up ownership of the not yet started coroutine.
+    Handle release() {
+        return std::exchange(h, nullptr);
+    }
+};
+
+}
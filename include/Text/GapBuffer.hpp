@@ -0,0 +1,145 @@
+#pragma once
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace io {
+
+// Contiguous storage with a movable hole at the edit position. Inserting and
+// erasing at the gap is O(1) amortized; moving the gap by n costs one memmove
+// of n elements, so edits that walk with a cursor stay cheap.
+template<typename T>
+class GapBuffer {
+    static_assert(std::is_trivially_copyable_v<T>);
+    static constexpr size_t min_capacity = 64;
+
+    std::unique_ptr<T[]> data;
+    size_t capacity_{0};
+    size_t gap_begin{0};
+    size_t gap_end{0};
+
+    void grow(size_t needed) {
+        size_t cap = std::max(min_capacity, capacity_);
+        while(cap - size() < needed)
+            cap *= 2;
+        auto d = std::make_unique<T[]>(cap);
+        size_t tail = capacity_ - gap_end;
+        if(data) {
+            std::memcpy(d.get(), data.get(), gap_begin * sizeof(T));
+            std::memcpy(d.get() + cap - tail, data.get() + gap_end, tail * sizeof(T));
+        }
+        gap_end = cap - tail;
+        capacity_ = cap;
+        data = std::move(d);
+    }
+public:
+    size_t size() const {
+        return capacity_ - (gap_end - gap_begin);
+    }
+    size_t capacity() const {
+        return capacity_;
+    }
+    bool empty() const {
+        return size() == 0;
+    }
+    size_t gap() const {
+        return gap_begin;
+    }
+
+    T operator[](size_t i) const {
+        return i < gap_begin ? data[i] : data[i + gap_end - gap_begin];
+    }
+
+    // Elements before and after the gap.
+    const T* before() const {
+        return data.get();
+    }
+    size_t before_size() const {
+        return gap_begin;
+    }
+    const T* after() const {
+        return data.get() + gap_end;
+    }
+    size_t after_size() const {
+        return capacity_ - gap_end;
+    }
+
+    void reserve(size_t n) {
+        if(n > capacity_)
+            grow(n - size());
+    }
+
+    void move_gap(size_t pos) {
+        if(pos > size())
+            throw std::out_of_range("GapBuffer position out of range");
+        if(pos < gap_begin) {
+            size_t n = gap_begin - pos;
+            std::memmove(data.get() + gap_end - n, data.get() + pos, n * sizeof(T));
+            gap_begin -= n;
+            gap_end -= n;
+        } else if(pos > gap_begin) {
+            size_t n = pos - gap_begin;
+            std::memmove(data.get() + gap_begin, data.get() + gap_end, n * sizeof(T));
+            gap_begin += n;
+            gap_end += n;
+        }
+    }
+
+    // Single steps, for cursor movement. Return false at either end.
+    bool step_left() {
+        if(!gap_begin)
+            return false;
+        data[--gap_end] = data[--gap_begin];
+        return true;
+    }
+    bool step_right() {
+        if(gap_end == capacity_)
+            return false;
+        data[gap_begin++] = data[gap_end++];
+        return true;
+    }
+
+    // Inserts at the gap, leaving the gap after the new elements.
+    void insert(const T* first, size_t count) {
+        if(!count)
+            return;
+        if(gap_end - gap_begin < count)
+            grow(count);
+        std::memcpy(data.get() + gap_begin, first, count * sizeof(T));
+        gap_begin += count;
+    }
+    void insert(T v) {
+        insert(&v, 1);
+    }
+    // Room for at least `count` elements at the gap, to be filled and then
+    // committed; lets producers write straight into the buffer.
+    T* prepare(size_t count) {
+        if(gap_end - gap_begin < count)
+            grow(count);
+        return data.get() + gap_begin;
+    }
+    void commit(size_t count) {
+        gap_begin += count;
+    }
+
+    // Erases up to `count` elements before or after the gap; returns how many.
+    size_t erase_before(size_t count) {
+        count = std::min(count, gap_begin);
+        gap_begin -= count;
+        return count;
+    }
+    size_t erase_after(size_t count) {
+        count = std::min(count, capacity_ - gap_end);
+        gap_end += count;
+        return count;
+    }
+
+    void clear() {
+        gap_begin = 0;
+        gap_end = capacity_;
+    }
+};
+
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "TextEdit.hpp"
+#include <string>
+
+namespace io {
+
+// Draws a TextEdit as a single terminal line and keeps it up to date from
+// TextEdit::take_damage(). Only the changed span is encoded and written; text
+// after it is shifted with insert/delete character escapes. A frame is one
+// write() and nothing is written when nothing changed.
+//
+// Assumes every codepoint occupies one column and the line does not wrap;
+// call invalidate() after anything else writes to the terminal.
+class TerminalTextRenderer {
+    GapBuffer<char> utf8;         // encoding of the text as last rendered
+    size_t utf8_gap_codepoint{0}; // codepoint index of utf8's gap
+    size_t length{0};             // codepoints rendered
+    bool full_redraw{true};
+    std::string frame;
+    std::string span;
+    int fd;
+
+    void seek(size_t codepoint);
+    void replace(size_t pos, size_t removed, const TextEdit& te, size_t count);
+    void flush();
+public:
+    explicit TerminalTextRenderer(int fd = 1);
+
+    // Returns false when there was nothing to draw.
+    bool render(TextEdit& te);
+    // Redraws the whole line on the next render().
+    void invalidate() {
+        full_redraw = true;
+    }
+
+    // Cached UTF-8 encoding of the rendered text.
+    std::string utf8_text() const;
+    size_t utf8_size() const {
+        return utf8.size();
+    }
+};
+
+}
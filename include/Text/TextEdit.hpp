@@ -0,0 +1,149 @@
+#pragma once
+#include "GapBuffer.hpp"
+#include <cinttypes>
+#include <limits>
+#include <string>
+
+namespace io {
+
+// What changed since the last TextEdit::take_damage(): the first `prefix` and
+// the last `suffix` codepoints are the same as then, everything in between
+// may differ.
+struct TextDamage {
+    static constexpr size_t none = std::numeric_limits<size_t>::max();
+
+    size_t prefix{none};
+    size_t suffix{none};
+    bool cursor_moved{false};
+
+    bool text_changed() const {
+        return prefix != none;
+    }
+};
+
+// Editable UTF-32 text with a cursor, stored in a gap buffer that is kept at
+// the cursor. Lines are separated by '\n'; words are runs of letters and
+// digits or runs of punctuation, separated by whitespace.
+class TextEdit {
+    GapBuffer<uint32_t> text;
+    TextDamage damage;
+
+    // Records that `removed` codepoints at `pos` are about to be replaced.
+    void damaged(size_t pos, size_t removed) {
+        damage.prefix = std::min(damage.prefix, pos);
+        damage.suffix = std::min(damage.suffix, text.size() - pos - removed);
+        damage.cursor_moved = true;
+    }
+
+    enum class CharClass { space, punctuation, word };
+    static CharClass classify(uint32_t c);
+    size_t line_start(size_t pos) const;
+    size_t line_end(size_t pos) const;
+public:
+    size_t size() const {
+        return text.size();
+    }
+    bool empty() const {
+        return text.empty();
+    }
+    size_t get_cursor() const {
+        return text.gap();
+    }
+    uint32_t operator[](size_t i) const {
+        return text[i];
+    }
+    // Bytes held by the storage, including the gap.
+    size_t memory_usage() const {
+        return text.capacity() * sizeof(uint32_t);
+    }
+
+    // Text before and after the cursor, each contiguous.
+    const uint32_t* before_cursor() const {
+        return text.before();
+    }
+    size_t before_cursor_size() const {
+        return text.before_size();
+    }
+    const uint32_t* after_cursor() const {
+        return text.after();
+    }
+    size_t after_cursor_size() const {
+        return text.after_size();
+    }
+
+    void insert(uint32_t codepoint) {
+        insert(&codepoint, 1);
+    }
+    void insert(const uint32_t* codepoints, size_t count) {
+        damaged(text.gap(), 0);
+        text.insert(codepoints, count);
+    }
+    void insert(const std::u32string& s) {
+        static_assert(sizeof(char32_t) == sizeof(uint32_t));
+        insert(reinterpret_cast<const uint32_t*>(s.data()), s.size());
+    }
+    // Decodes UTF-8, e.g. a clipboard paste; ill-formed input becomes U+FFFD.
+    void insert_utf8(const char* utf8, size_t size);
+    void insert_utf8(const std::string& utf8) {
+        insert_utf8(utf8.data(), utf8.size());
+    }
+    // Both return false when there was nothing to erase.
+    bool backspace() {
+        if(!text.gap())
+            return false;
+        damaged(text.gap() - 1, 1);
+        return text.erase_before(1);
+    }
+    bool delete_() {
+        if(!text.after_size())
+            return false;
+        damaged(text.gap(), 1);
+        return text.erase_after(1);
+    }
+    void clear() {
+        damaged(0, text.size());
+        text.clear();
+    }
+    void reserve(size_t n) {
+        text.reserve(n);
+    }
+
+    // Movement returns false when the cursor did not move.
+    bool set_cursor(size_t pos);
+    bool move_left() {
+        if(!text.step_left())
+            return false;
+        damage.cursor_moved = true;
+        return true;
+    }
+    bool move_right() {
+        if(!text.step_right())
+            return false;
+        damage.cursor_moved = true;
+        return true;
+    }
+    bool move_word_left();
+    bool move_word_right();
+    bool move_line_start();
+    bool move_line_end();
+    // Keep the column, clamped to the length of the target line.
+    bool move_line_up();
+    bool move_line_down();
+    bool move_start() {
+        return set_cursor(0);
+    }
+    bool move_end() {
+        return set_cursor(text.size());
+    }
+
+    std::u32string str() const;
+
+    // Returns the damage accumulated since the previous call and resets it.
+    TextDamage take_damage() {
+        auto d = damage;
+        damage = {};
+        return d;
+    }
+};
+
+}
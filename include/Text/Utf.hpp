@@ -0,0 +1,36 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <string>
+
+namespace io {
+
+// UTF-32 <-> UTF-8 transcoding with vectorized runs of ASCII. Ill-formed
+// input never fails: surrogates and values above U+10FFFF encode as U+FFFD,
+// and each maximal ill-formed UTF-8 subsequence decodes to one U+FFFD.
+
+enum class UtfPath {
+    scalar,
+    sse2,
+    avx2
+};
+
+// Best path the CPU supports, chosen on first use.
+UtfPath get_utf_path();
+// Forces a path, e.g. for benchmarks; one the CPU lacks falls back to scalar.
+void set_utf_path(UtfPath path);
+
+constexpr size_t max_utf8_size(size_t codepoints) {
+    return codepoints * 4;
+}
+
+// `out` must hold max_utf8_size(count) bytes. Returns the bytes written.
+size_t utf32_to_utf8(const uint32_t* in, size_t count, char* out);
+void append_utf8(std::string& out, const uint32_t* in, size_t count);
+
+// `out` must hold `size` codepoints. Returns the codepoints written.
+size_t utf8_to_utf32(const char* in, size_t size, uint32_t* out);
+
+bool validate_utf8(const char* in, size_t size);
+
+}
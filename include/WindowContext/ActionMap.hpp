@@ -0,0 +1,133 @@
+#pragma once
+#include "EpochReclaimer.hpp"
+#include "InputEvent.hpp"
+#include "InputState.hpp"
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <mutex>
+#include <vector>
+
+namespace io {
+
+using ActionId = uint16_t;
+
+struct ActionBinding {
+    static constexpr int no_input = -1;
+
+    int input;                  // key code or ActionMap::mouse_button(button)
+    uint8_t actions;            // ActionMap::on_press | on_release | on_repeat
+    uint8_t mods{0};            // modifier bits that must be set ...
+    uint8_t mods_mask{0};       // ... among these; 0 ignores modifiers
+    std::array<int, 3> chord{no_input, no_input, no_input};  // inputs held as well
+    ActionId action;
+};
+
+struct ActionStates {
+    static constexpr size_t max_actions = 1024;
+
+    std::bitset<max_actions> active;     // bound input (and chord) held
+    std::bitset<max_actions> triggered;  // pressed since the previous snapshot
+    std::bitset<max_actions> released;   // released since the previous snapshot
+};
+
+// Maps keys and mouse buttons to action ids through a table indexed directly
+// by (input, GLFW action). Bindings can change from any thread: the table is
+// rebuilt by the writer and swapped in, process() and evaluate() only read.
+// process() works on its own copy, refreshed when the version changes, so
+// an event costs no epoch pin.
+class ActionMap {
+public:
+    // Bit n selects GLFW action n (GLFW_RELEASE, GLFW_PRESS, GLFW_REPEAT).
+    static constexpr uint8_t on_release = 1 << 0;
+    static constexpr uint8_t on_press = 1 << 1;
+    static constexpr uint8_t on_repeat = 1 << 2;
+    static constexpr size_t input_count = InputState::key_count + InputState::button_count;
+
+    static constexpr int mouse_button(int button) {
+        return static_cast<int>(InputState::key_count) + button;
+    }
+private:
+    static constexpr size_t action_kinds = 3;
+
+    struct Binding {
+        uint8_t mods, mods_mask;
+        ActionId action;
+        std::array<int16_t, 3> chord;
+    };
+    struct Table {
+        std::array<uint16_t, input_count * action_kinds + 1> first{};
+        std::vector<Binding> bindings;
+        std::vector<ActionBinding> source;
+    };
+
+    EpochReclaimer reclaimer;
+    EpochSlot<Table> table;
+    std::atomic<uint64_t> version{0};
+    std::mutex mutex;
+    std::vector<ActionBinding> bindings;
+    // Consumer thread.
+    std::bitset<input_count> held;
+    Table cached;
+    uint64_t cached_version{0};
+
+    void rebuild();
+    void refresh(uint64_t v);
+    static bool chord_held(const Binding& b, const std::bitset<input_count>& held);
+    static bool mods_match(const Binding& b, int mods) {
+        return (mods & b.mods_mask) == (b.mods & b.mods_mask);
+    }
+    const Binding* find(int input, int action, size_t& count) const;
+public:
+    ActionMap();
+
+    // Throws std::out_of_range for inputs or action ids outside the table and
+    // std::invalid_argument for mods outside mods_mask.
+    void bind(const ActionBinding& binding);
+    void bind(int input, uint8_t actions, ActionId action, uint8_t mods = 0, uint8_t mods_mask = 0);
+    // Drops every binding of `action`.
+    void unbind(ActionId action);
+    void clear();
+
+    // Feeds a key or mouse button event, calling fn(ActionId, int glfw_action)
+    // for each matching binding. Returns true when any binding matched.
+    // Consumer thread only.
+    template<typename FN>
+    bool process(const InputEvent& e, FN&& fn) {
+        int input, action, mods;
+        if(e.type == EventType::key_input) {
+            input = e.key.key;
+            action = e.key.action;
+            mods = e.key.mods;
+        } else if(e.type == EventType::mouse_input) {
+            input = mouse_button(e.button.button);
+            action = e.button.action;
+            mods = e.button.mods;
+        } else {
+            return false;
+        }
+        if(input < 0 || static_cast<size_t>(input) >= input_count
+                || action < 0 || static_cast<size_t>(action) >= action_kinds)
+            return false;
+        held.set(input, action != 0);
+
+        auto v = version.load(std::memory_order_acquire);
+        if(v != cached_version)
+            refresh(v);
+        size_t count;
+        auto b = find(input, action, count);
+        bool matched = false;
+        for(auto end = b + count; b != end; ++b) {
+            if(!mods_match(*b, mods) || !chord_held(*b, held))
+                continue;
+            matched = true;
+            fn(b->action, action);
+        }
+        return matched;
+    }
+
+    // Evaluates every binding against a polled snapshot in one pass.
+    void evaluate(const InputState& state, ActionStates& out);
+};
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+namespace io {
+
+// Counter written by one thread at a time: an increment is a relaxed load
+// and store, with no locked instruction. Reads from any thread see a recent
+// value.
+class RelaxedCounter {
+    std::atomic<uint64_t> v{0};
+public:
+    RelaxedCounter() = default;
+    // Copies a snapshot, for counters that move along with their owner.
+    RelaxedCounter(const RelaxedCounter& o) : v(o.get()) {}
+    RelaxedCounter& operator=(const RelaxedCounter& o) {
+        v.store(o.get(), std::memory_order_relaxed);
+        return *this;
+    }
+
+    void add(uint64_t n = 1) {
+        v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+    void raise_to(uint64_t n) {
+        if(n > v.load(std::memory_order_relaxed))
+            v.store(n, std::memory_order_relaxed);
+    }
+    uint64_t get() const {
+        return v.load(std::memory_order_relaxed);
+    }
+};
+
+// Execution time of a listener's calls.
+struct TimingCounters {
+    RelaxedCounter calls, total_ns, max_ns;
+
+    void record(uint64_t ns) {
+        calls.add();
+        total_ns.add(ns);
+        max_ns.raise_to(ns);
+    }
+};
+
+// Execution time of one listener, written by the thread running it.
+struct alignas(64) ListenerCounters : TimingCounters {};
+
+// Events per second over windows of at least a second, single writer.
+class RateCounter {
+    static constexpr uint64_t window = 1'000'000'000;
+
+    RelaxedCounter total;
+    std::atomic<uint64_t> window_start{0}, window_count{0};
+    std::atomic<double> last_rate{0};
+public:
+    void add(uint64_t now) {
+        total.add();
+        auto start = window_start.load(std::memory_order_relaxed);
+        auto n = window_count.load(std::memory_order_relaxed) + 1;
+        if(!start || now - start >= window) {
+            if(start)
+                last_rate.store(n * 1e9 / (now - start), std::memory_order_relaxed);
+            window_start.store(now, std::memory_order_relaxed);
+            n = 0;
+        }
+        window_count.store(n, std::memory_order_relaxed);
+    }
+    uint64_t count() const {
+        return total.get();
+    }
+    // The last full window's rate, or the average since it ended once that
+    // is a window long, e.g. after the writer went idle.
+    double rate(uint64_t now) const {
+        auto start = window_start.load(std::memory_order_relaxed);
+        if(start && now - start >= window)
+            return window_count.load(std::memory_order_relaxed) * 1e9 / (now - start);
+        return last_rate.load(std::memory_order_relaxed);
+    }
+};
+
+}
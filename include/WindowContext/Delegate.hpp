@@ -0,0 +1,138 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace io {
+
+template<typename Signature>
+class Delegate;
+
+// Type-erased callable with inline storage and no heap allocation. A call is
+// a single indirect call through `invoke`; member functions are bound as
+// template arguments so their thunk calls the method directly.
+template<typename R, typename ...Args>
+class Delegate<R(Args...)> {
+public:
+    static constexpr size_t storage_size = 4 * sizeof(void*);
+private:
+    enum class Op { copy, move, destroy };
+    using Invoke_t = R(*)(void*, Args...);
+    using Manage_t = void(*)(Op, void*, void*);
+
+    alignas(std::max_align_t) mutable unsigned char storage[storage_size];
+    Invoke_t invoke{nullptr};
+    Manage_t manage{nullptr};
+
+    template<typename F>
+    static R call(void* s, Args... args) {
+        return (*static_cast<F*>(s))(std::forward<Args>(args)...);
+    }
+    template<auto Method, typename T>
+    static R call_method(void* s, Args... args) {
+        return ((*static_cast<T**>(s))->*Method)(std::forward<Args>(args)...);
+    }
+    template<typename F>
+    static void manage_fn(Op op, void* dst, void* src) {
+        switch(op) {
+        case Op::copy:
+            new (dst) F(*static_cast<const F*>(src));
+            break;
+        case Op::move:
+            new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+            break;
+        case Op::destroy:
+            static_cast<F*>(dst)->~F();
+            break;
+        }
+    }
+
+    void reset() {
+        if(manage)
+            manage(Op::destroy, storage, nullptr);
+        invoke = nullptr;
+        manage = nullptr;
+    }
+    void copy_from(const Delegate& o) {
+        if(o.manage)
+            o.manage(Op::copy, storage, o.storage);
+        else
+            std::memcpy(storage, o.storage, storage_size);
+        invoke = o.invoke;
+        manage = o.manage;
+    }
+    void move_from(Delegate& o) {
+        if(o.manage)
+            o.manage(Op::move, storage, o.storage);
+        else
+            std::memcpy(storage, o.storage, storage_size);
+        invoke = o.invoke;
+        manage = o.manage;
+        o.invoke = nullptr;
+        o.manage = nullptr;
+    }
+public:
+    Delegate() = default;
+    Delegate(std::nullptr_t) {}
+
+    template<typename F, typename = std::enable_if_t<
+                 !std::is_same_v<std::decay_t<F>, Delegate> &&
+                 std::is_invocable_r_v<R, std::decay_t<F>&, Args...>>>
+    Delegate(F&& f) {
+        using Fn = std::decay_t<F>;
+        static_assert(sizeof(Fn) <= storage_size,
+                      "callable does not fit the inline storage, capture a pointer instead");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t));
+        new (storage) Fn(std::forward<F>(f));
+        invoke = &call<Fn>;
+        if constexpr(!std::is_trivially_copyable_v<Fn> || !std::is_trivially_destructible_v<Fn>)
+            manage = &manage_fn<Fn>;
+    }
+
+    template<auto Method, typename T>
+    static Delegate bind(T* obj) {
+        Delegate d;
+        if(!obj)
+            return d;
+        new (d.storage) T*(obj);
+        d.invoke = &call_method<Method, T>;
+        return d;
+    }
+
+    Delegate(const Delegate& o) {
+        copy_from(o);
+    }
+    Delegate(Delegate&& o) noexcept {
+        move_from(o);
+    }
+    Delegate& operator=(const Delegate& o) {
+        if(this != &o) {
+            reset();
+            copy_from(o);
+        }
+        return *this;
+    }
+    Delegate& operator=(Delegate&& o) noexcept {
+        if(this != &o) {
+            reset();
+            move_from(o);
+        }
+        return *this;
+    }
+    ~Delegate() {
+        reset();
+    }
+
+    explicit operator bool() const {
+        return invoke != nullptr;
+    }
+
+    R operator()(Args... args) const {
+        return invoke(storage, std::forward<Args>(args)...);
+    }
+};
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cinttypes>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace io {
+
+// Epoch-based reclamation for objects read on the dispatch path and replaced
+// from arbitrary threads. Readers pin the current epoch with two atomic
+// operations and never block; a retired object is freed once the global
+// epoch has moved two steps past the one it was retired in, which can only
+// happen after every reader that might still see it has unpinned.
+class EpochReclaimer {
+    static constexpr size_t cache_line = 64;
+
+    struct alignas(cache_line) Counter {
+        std::atomic_uint64_t v{0};
+    };
+    struct Retired {
+        uint64_t epoch;
+        void* ptr;
+        void (*deleter)(void*);
+    };
+
+    std::atomic_uint64_t epoch{2};
+    Counter readers[2];
+    std::mutex retired_mutex;
+    std::vector<Retired> retired;
+
+    bool try_advance();
+    void free_safe();
+    void retire(void* ptr, void (*deleter)(void*));
+public:
+    class Guard {
+        Counter* counter;
+        friend class EpochReclaimer;
+        explicit Guard(Counter* c) : counter(c) {}
+    public:
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard() {
+            counter->v.fetch_sub(1, std::memory_order_release);
+        }
+    };
+
+    EpochReclaimer() = default;
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+    ~EpochReclaimer();
+
+    Guard pin() {
+        for(;;) {
+            auto e = epoch.load(std::memory_order_seq_cst);
+            auto& c = readers[e & 1];
+            c.v.fetch_add(1, std::memory_order_seq_cst);
+            if(epoch.load(std::memory_order_seq_cst) == e)
+                return Guard(&c);
+            c.v.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    template<typename T>
+    void retire(T* ptr) {
+        retire(ptr, [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    // Frees what is safe to free without waiting for the retire lock.
+    void collect();
+};
+
+// Pointer slot published to pinned readers and replaced from any thread.
+template<typename T>
+class EpochSlot {
+    std::atomic<T*> ptr{nullptr};
+public:
+    EpochSlot() = default;
+    EpochSlot(const EpochSlot&) = delete;
+    EpochSlot& operator=(const EpochSlot&) = delete;
+    ~EpochSlot() {
+        delete ptr.load();
+    }
+
+    // Only valid while the caller holds an EpochReclaimer::Guard.
+    T* load() const {
+        return ptr.load(std::memory_order_acquire);
+    }
+
+    void store(EpochReclaimer& reclaimer, std::unique_ptr<T> v) {
+        if(auto old = ptr.exchange(v.release(), std::memory_order_seq_cst))
+            reclaimer.retire(old);
+    }
+};
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "InputEvent.hpp"
+
+namespace io {
+
+// Folds the motion events of one drain into a single event per type: relative
+// mouse movement and scroll deltas are summed, the cursor position keeps the
+// latest value. Each carries the timestamp of its newest sample, so its
+// queued latency is that of the freshest input it delivers. Any other event
+// flushes the accumulation first so that motion never crosses a key, button,
+// character or resize event.
+class EventCoalescer {
+    InputEvent position, movement, scroll;
+    bool has_position{false}, has_movement{false}, has_scroll{false};
+
+    static void accumulate(InputEvent& acc, bool& has, const InputEvent& e) {
+        if(has) {
+            acc.position.x += e.position.x;
+            acc.position.y += e.position.y;
+            acc.timestamp = e.timestamp;
+        } else {
+            acc = e;
+            has = true;
+        }
+    }
+public:
+    template<typename FN>
+    void push(const InputEvent& e, FN&& fn) {
+        switch(e.type) {
+        case EventType::cursor_position:
+            position = e;
+            has_position = true;
+            break;
+        case EventType::mouse_movement:
+            accumulate(movement, has_movement, e);
+            break;
+        case EventType::scroll_input:
+            accumulate(scroll, has_scroll, e);
+            break;
+        default:
+            flush(fn);
+            fn(e);
+            break;
+        }
+    }
+
+    template<typename FN>
+    void flush(FN&& fn) {
+        if(has_position) {
+            has_position = false;
+            fn(position);
+        }
+        if(has_movement) {
+            has_movement = false;
+            fn(movement);
+        }
+        if(has_scroll) {
+            has_scroll = false;
+            fn(scroll);
+        }
+    }
+};
+
+}
@@ -0,0 +1,203 @@
+#pragma once
+#include "EpochReclaimer.hpp"
+#include "EventCoalescer.hpp"
+#include "EventLog.hpp"
+#include "EventQueue.hpp"
+#include "Executor.hpp"
+#include "HandlerTable.hpp"
+#include "InputState.hpp"
+#include "InputStats.hpp"
+#include "LatencyHistogram.hpp"
+#include <condition_variable>
+#include <unordered_map>
+#include <vector>
+
+namespace io {
+
+// Receives the event types that listeners, filters, recording or state
+// tracking currently need from the backend.
+using InterestCallback = Delegate<void(uint32_t types)>;
+
+// Backend-independent half of a window context: the producer side queues and
+// tracks events, the consumer side drains them into the registered handlers.
+// Every backend feeds one of these so dispatch costs are identical.
+class EventDispatcher {
+    static constexpr uint64_t inline_id_bit = uint64_t(1) << 63;
+
+    struct ExecutorListener {
+        SubscriptionToken token;
+        std::shared_ptr<SerialQueue> queue;
+    };
+    // Producer and consumer counters on separate cache lines.
+    struct alignas(64) ProducerCounters {
+        RelaxedCounter received, filtered, unfocused;
+    };
+    struct alignas(64) ConsumerCounters {
+        RelaxedCounter delivered;
+    };
+    struct DrainHook {
+        uint64_t id;
+        DrainCallback callback;
+    };
+
+    EpochReclaimer reclaimer;
+    HandlerTable handlers;
+    HandlerTable inline_handlers{inline_id_bit};
+    std::atomic<size_t> inline_count{0};
+    std::mutex executor_mutex;
+    std::shared_ptr<Executor> executor;
+    std::unordered_map<uint64_t, ExecutorListener> executor_listeners;
+    EventAdmission admission;
+    std::atomic_bool track_state{false};
+    // The callback runs outside interest_mutex, one call at a time: a change
+    // made while it runs bumps the generation and the running call repeats
+    // with the latest types.
+    std::mutex interest_mutex;
+    std::condition_variable interest_idle;
+    InterestCallback interest_callback;
+    uint32_t interest_types{0};
+    uint64_t interest_generation{0};
+    uint64_t notified_generation{0};
+    bool notifying{false};
+    EpochSlot<InputEventCallback> input_event_callback;
+    EpochSlot<CharactersInputCallback> characters_callback;
+    EpochSlot<CharacterInputCallback> character_callback;  // per codepoint instead
+    EpochSlot<DrainCallback> drain_callback;
+    // Copied on change under drain_hooks_mutex, like the handler lists.
+    std::mutex drain_hooks_mutex;
+    uint64_t next_drain_hook{1};
+    EpochSlot<std::vector<DrainHook>> drain_hooks;
+    std::vector<uint32_t> characters;
+    EpochSlot<EventRecorder> recorder;
+    InputStateTracker state;
+    std::mutex prediction_mutex;
+    bool prediction{false};
+    PredictionConfig prediction_config;
+    std::atomic<uint32_t> prediction_version{0};
+    uint32_t applied_prediction{0};  // producer
+    SPSCQueue<InputEvent> queue;
+    std::atomic_bool coalesce_motion{false};
+    EventCoalescer coalescer;
+    LatencyHistograms latency;
+    // When the last delivered event's handlers returned, i.e. when the next
+    // one leaves the queue.
+    uint64_t dispatch_time{0};
+    std::array<ProducerCounters, event_type_count> produced;
+    std::array<ConsumerCounters, event_type_count> consumed;
+    alignas(64) RateCounter wakeups;
+    StatsSink stats_sink;
+    uint64_t stats_period{0};
+    uint64_t next_stats{0};
+
+    void track(const InputEvent& e);
+    void apply_prediction();
+    bool dispatch_inline(const InputEvent& e);
+    void update_interest();
+    void notify_interest();
+    SubscriptionToken subscribe_to(EventType type, EventHandler handler, int priority,
+                                   ListenerAffinity affinity, const EventFilter& filter);
+    void deliver(const InputEvent& e);
+    void flush_characters();
+    void hand_over_characters(const uint32_t* codepoints, size_t count);
+    void collect_characters();
+public:
+    explicit EventDispatcher(size_t queue_capacity);
+    EventDispatcher(const EventDispatcher&) = delete;
+    EventDispatcher& operator=(const EventDispatcher&) = delete;
+    ~EventDispatcher();
+
+    // Producer side.
+    void push(InputEvent e) {
+        e.timestamp = monotonic_ns();
+        push_stamped(e);
+    }
+    // Events no handler's filter admits are tracked but not queued.
+    void push_stamped(const InputEvent& e) {
+        auto& c = produced[static_cast<size_t>(e.type)];
+        c.received.add();
+        if(track_state.load(std::memory_order_relaxed))
+            track(e);
+        if(!admission.admits(e)) {
+            c.filtered.add();
+            return;
+        }
+        if(inline_count.load(std::memory_order_relaxed) && dispatch_inline(e))
+            return;
+        queue.push(e);
+    }
+    // The backend dropped an event because its window was not focused.
+    void count_unfocused(EventType type) {
+        produced[static_cast<size_t>(type)].unfocused.add();
+    }
+    // The backend woke up to look for input; from one thread at a time.
+    void count_wakeup() {
+        wakeups.add(monotonic_ns());
+    }
+    void release_all() {
+        state.release_all(monotonic_ns());
+    }
+    void publish_state() {
+        state.publish();
+    }
+
+    // Consumer side.
+    size_t drain();
+
+    void set_slot(EventType type, EventHandler handler);
+    void set_slot(EventType type, SlotCallback callback);
+    void set_input_event_callback(InputEventCallback cb);
+    // Runs at the end of every drain, after the last handler.
+    void set_drain_callback(DrainCallback cb);
+    // Run in the order added, before the drain callback. Any thread.
+    uint64_t add_drain_callback(DrainCallback cb);
+    bool remove_drain_callback(uint64_t id);
+    // The character slot: characters that reach it are collected and handed
+    // over as one span before the next other event and at the end of a drain.
+    void set_characters_slot(CharactersInputCallback cb);
+    // The same, handing the characters over one call each.
+    void set_characters_slot(CharacterInputCallback cb);
+    // Hands `codepoints` to the character slot in one call, recording them as
+    // character events. Consumer thread only.
+    void deliver_characters(const uint32_t* codepoints, size_t count);
+    SubscriptionToken subscribe(EventType type, EventHandler handler, int priority,
+                                ListenerAffinity affinity = ListenerAffinity::main_thread,
+                                const EventFilter& filter = {});
+    bool unsubscribe(SubscriptionToken token);
+    std::vector<ListenerQueueStats> get_listener_queue_stats();
+
+    void start_recording(const std::string& path);
+    void stop_recording();
+
+    // Called with the needed types now and after every change, from the
+    // thread making the change or, if a call is already running, from that
+    // one. Returns once no call with the previous callback is running.
+    void set_interest_callback(InterestCallback cb);
+    void set_state_tracking(bool val);
+    // Applied by the producer at its next tracked event; throws
+    // std::invalid_argument for a bad config.
+    void set_motion_prediction(bool val, const PredictionConfig& config);
+
+    // Counters since construction; callable from any thread.
+    InputStats stats();
+    // Hands stats() to `sink` at the end of a drain, at most every
+    // `period_ns`. Consumer thread only; a null sink stops it.
+    void set_stats_sink(StatsSink sink, uint64_t period_ns);
+
+    void set_motion_coalescing(bool val) {
+        coalesce_motion = val;
+    }
+    const InputState& get_input_state() const {
+        return state.snapshot();
+    }
+    EventQueueStats get_event_queue_stats() const {
+        return queue.stats();
+    }
+    LatencySnapshot get_latency_snapshot() const {
+        return latency.snapshot();
+    }
+    void reset_latency_histograms() {
+        latency.reset();
+    }
+};
+
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "InputEvent.hpp"
+#include "InputState.hpp"
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <limits>
+
+namespace io {
+
+constexpr uint32_t event_bit(EventType type) {
+    return uint32_t(1) << static_cast<uint32_t>(type);
+}
+constexpr uint32_t all_event_types = (uint32_t(1) << event_type_count) - 1;
+
+// Declarative subscription filter on key_input, mouse_input and
+// gamepad_button: a range of key or button codes, GLFW actions and modifiers
+// (gamepad buttons have none). Other types always match.
+struct EventFilter {
+    // Bit n selects GLFW action n, as in ActionMap.
+    static constexpr uint8_t on_release = 1 << 0;
+    static constexpr uint8_t on_press = 1 << 1;
+    static constexpr uint8_t on_repeat = 1 << 2;
+    static constexpr uint8_t any_action = on_release | on_press | on_repeat;
+
+    int first{std::numeric_limits<int>::min()};
+    int last{std::numeric_limits<int>::max()};
+    uint8_t actions{any_action};
+    uint8_t mods{0};       // modifier bits that must be set ...
+    uint8_t mods_mask{0};  // ... among these; 0 ignores modifiers
+
+    static constexpr EventFilter any(uint8_t actions) {
+        EventFilter f;
+        f.actions = actions;
+        return f;
+    }
+    static constexpr EventFilter codes(int first, int last, uint8_t actions = any_action) {
+        return {first, last, actions};
+    }
+    static constexpr EventFilter code(int code, uint8_t actions = any_action) {
+        return {code, code, actions};
+    }
+
+    constexpr bool is_trivial() const {
+        return first == std::numeric_limits<int>::min() && last == std::numeric_limits<int>::max()
+            && (actions & any_action) == any_action && !mods_mask;
+    }
+    bool matches(const InputEvent& e) const {
+        int code, action, m;
+        switch(e.type) {
+        case EventType::key_input:
+            code = e.key.key, action = e.key.action, m = e.key.mods;
+            break;
+        case EventType::mouse_input:
+            code = e.button.button, action = e.button.action, m = e.button.mods;
+            break;
+        case EventType::gamepad_button:
+            code = e.gamepad.code, action = e.gamepad.action, m = 0;
+            break;
+        default:
+            return true;
+        }
+        return code >= first && code <= last && (actions >> action & 1)
+            && (m & mods_mask) == (mods & mods_mask);
+    }
+};
+
+// What the producer queues: the event types someone handles and, for
+// key_input and mouse_input handled only through filters, the union of the
+// filters' codes and actions. Rebuilt on the registration path and read
+// with relaxed loads, so during a change an event may be queued or dropped
+// by either version; handlers check their own filter again.
+class EventAdmission {
+    static constexpr size_t code_count = InputState::key_count + InputState::button_count;
+    static constexpr size_t word_count = (code_count + 63) / 64;
+
+    static int code_of(const InputEvent& e) {
+        if(e.type == EventType::key_input)
+            return InputState::valid_key(e.key.key) ? e.key.key : -1;
+        return InputState::valid_button(e.button.button)
+            ? static_cast<int>(InputState::key_count) + e.button.button : -1;
+    }
+
+    std::atomic<uint32_t> types{0};
+    std::atomic<uint32_t> unfiltered{0};
+    std::array<std::atomic<uint64_t>, word_count> codes{};
+    std::atomic<uint8_t> key_actions{0}, button_actions{0};
+public:
+    struct Builder {
+        uint32_t types{0};
+        uint32_t unfiltered{0};
+        std::bitset<code_count> codes;
+        uint8_t key_actions{0}, button_actions{0};
+
+        void add_all() {
+            types = unfiltered = all_event_types;
+        }
+        // A handler of `type`; `filter` is nullptr when it takes every event.
+        void add(EventType type, const EventFilter* filter);
+    };
+
+    void publish(const Builder& b);
+
+    bool admits(const InputEvent& e) const {
+        auto bit = event_bit(e.type);
+        if(unfiltered.load(std::memory_order_relaxed) & bit)
+            return true;
+        if(!(types.load(std::memory_order_relaxed) & bit))
+            return false;
+        if(e.type != EventType::key_input && e.type != EventType::mouse_input)
+            return true;
+        int code = code_of(e);
+        if(code < 0 || !(codes[code / 64].load(std::memory_order_relaxed) >> (code % 64) & 1))
+            return false;
+        return e.type == EventType::key_input
+            ? key_actions.load(std::memory_order_relaxed) >> e.key.action & 1
+            : button_actions.load(std::memory_order_relaxed) >> e.button.action & 1;
+    }
+};
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "InputEvent.hpp"
+#include <cstdio>
+#include <string>
+
+namespace io {
+
+// Append-only binary event log.
+//
+// Header (32 bytes): magic "IOEVLOG\0", u16 version, u16 header size,
+// u16 byte order mark 0x0102, u16 reserved, u64 timestamp of the first
+// event, u64 reserved. Records follow back to back: u8 event type, LEB128
+// nanoseconds since the previous record, then a payload fixed by the type
+// (key/button: i16 code, u8 action, u8 mods; positions and deltas: two f64;
+// resize: two i32; character: u32; gamepad: u8 pad, u8 button or axis,
+// u8 action, u8 reserved, f32 value). Values are stored in host byte order,
+// which the byte order mark lets readers check. A truncated final record,
+// e.g. after a crash, is ignored on replay. Version 2 added the gamepad
+// records; version 1 logs read unchanged.
+struct EventLogFormat {
+    static constexpr char magic[8] = {'I', 'O', 'E', 'V', 'L', 'O', 'G', '\0'};
+    static constexpr uint16_t version = 2;
+    static constexpr uint16_t header_size = 32;
+    static constexpr uint16_t byte_order = 0x0102;
+};
+
+class EventRecorder {
+    std::FILE* file{nullptr};
+    uint64_t last_timestamp{0};
+    uint64_t records{0};
+    bool header_written{false};
+    char buffer[1 << 16];
+
+    void write_header(uint64_t start);
+public:
+    explicit EventRecorder(const std::string& path);
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+    ~EventRecorder();
+
+    void record(const InputEvent& e);
+    void flush();
+    uint64_t recorded() const {
+        return records;
+    }
+};
+
+// Reads a log through a read-only memory mapping.
+class EventLogReader {
+    const unsigned char* data{nullptr};
+    size_t size{0};
+    size_t offset{0};
+    uint64_t start_timestamp{0};
+    uint64_t last_timestamp{0};
+public:
+    explicit EventLogReader(const std::string& path);
+    EventLogReader(const EventLogReader&) = delete;
+    EventLogReader& operator=(const EventLogReader&) = delete;
+    ~EventLogReader();
+
+    uint64_t get_start_timestamp() const {
+        return start_timestamp;
+    }
+    // Returns false at the end of the log.
+    bool next(InputEvent& e);
+    void rewind();
+};
+
+}
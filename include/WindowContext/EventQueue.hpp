@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cinttypes>
+#include <cstddef>
+#include <memory>
+
+namespace io {
+
+struct EventQueueStats {
+    size_t capacity;
+    size_t size;
+    size_t high_watermark;  // largest backlog seen at the start of a drain
+    uint64_t pushed;
+    uint64_t dropped;       // events lost because the queue was full
+    uint64_t overflows;     // number of times the queue ran full
+};
+
+// Bounded single-producer/single-consumer ring. push() is only called from
+// the thread pumping window events, consume_all() only from the thread
+// delivering them to listeners.
+template<typename T>
+class SPSCQueue {
+    static constexpr size_t cache_line = 64;
+
+    std::unique_ptr<T[]> buffer;
+    size_t mask;
+
+    alignas(cache_line) std::atomic_size_t tail{0};
+    size_t cached_head{0};
+    bool overflowing{false};
+    std::atomic_uint64_t pushed{0};
+    std::atomic_uint64_t dropped{0};
+    std::atomic_uint64_t overflows{0};
+
+    alignas(cache_line) std::atomic_size_t head{0};
+    size_t cached_tail{0};
+    std::atomic_size_t high_watermark{0};
+
+    static size_t round_up(size_t v) {
+        size_t p = 1;
+        while(p < v)
+            p <<= 1;
+        return p;
+    }
+public:
+    explicit SPSCQueue(size_t capacity)
+        : buffer(std::make_unique<T[]>(round_up(capacity)))
+        , mask(round_up(capacity) - 1) {}
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    bool push(const T& v) {
+        auto t = tail.load(std::memory_order_relaxed);
+        if(t - cached_head > mask) {
+            cached_head = head.load(std::memory_order_acquire);
+            if(t - cached_head > mask) {
+                dropped.store(dropped.load(std::memory_order_relaxed) + 1,
+                              std::memory_order_relaxed);
+                if(!overflowing) {
+                    overflowing = true;
+                    overflows.store(overflows.load(std::memory_order_relaxed) + 1,
+                                    std::memory_order_relaxed);
+                }
+                return false;
+            }
+        }
+        overflowing = false;
+        buffer[t & mask] = v;
+        tail.store(t + 1, std::memory_order_release);
+        pushed.store(pushed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    template<typename FN>
+    size_t consume_all(FN&& fn) {
+        auto h = head.load(std::memory_order_relaxed);
+        cached_tail = tail.load(std::memory_order_acquire);
+        auto n = cached_tail - h;
+        if(n > high_watermark.load(std::memory_order_relaxed))
+            high_watermark.store(n, std::memory_order_relaxed);
+        for(; h != cached_tail; ++h)
+            fn(buffer[h & mask]);
+        head.store(h, std::memory_order_release);
+        return n;
+    }
+
+    EventQueueStats stats() const {
+        auto h = head.load(std::memory_order_acquire);
+        auto t = tail.load(std::memory_order_acquire);
+        return {capacity(),
+                t - h,
+                high_watermark.load(std::memory_order_relaxed),
+                pushed.load(std::memory_order_relaxed),
+                dropped.load(std::memory_order_relaxed),
+                overflows.load(std::memory_order_relaxed)};
+    }
+};
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include "HandlerTable.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace io {
+
+class Executor;
+
+// The events of one executor listener. At most one worker runs them at a
+// time, in the order they were posted.
+class SerialQueue : public std::enable_shared_from_this<SerialQueue> {
+    Executor& executor;
+    EventHandler handler;
+    std::shared_ptr<ListenerCounters> counters{std::make_shared<ListenerCounters>()};
+    std::mutex mutex;
+    std::condition_variable idle;
+    std::deque<InputEvent> events;
+    bool scheduled{false};
+    bool running{false};
+    std::atomic_bool closed{false};
+    size_t high_watermark{0};
+    uint64_t delivered{0};
+public:
+    SerialQueue(Executor& executor, EventHandler handler);
+    SerialQueue(const SerialQueue&) = delete;
+    SerialQueue& operator=(const SerialQueue&) = delete;
+
+    void post(const InputEvent& e);
+    // Runs a batch of events; called by the executor only.
+    void run();
+    // Drops pending events and waits for the handler to return, unless
+    // called from the handler itself. Later posts are ignored.
+    void close();
+    ListenerQueueStats stats(SubscriptionToken token);
+    const std::shared_ptr<ListenerCounters>& get_counters() const {
+        return counters;
+    }
+};
+
+// Small pool shared by every window context. Each worker takes runnable
+// queues from its own deque and steals from the others when that runs dry.
+class Executor {
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<std::shared_ptr<SerialQueue>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+    std::atomic<size_t> pending{0};
+    std::atomic<size_t> sleepers{0};
+    std::atomic<size_t> next_worker{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping{false};
+
+    std::shared_ptr<SerialQueue> take(size_t self);
+    void worker_fn(size_t self);
+public:
+    explicit Executor(size_t thread_count);
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    // Must not run on a worker, i.e. don't drop the last window context from
+    // an executor listener.
+    ~Executor();
+
+    void submit(std::shared_ptr<SerialQueue> task);
+
+    // The pool in use, created with up to four workers if there is none.
+    static std::shared_ptr<Executor> acquire();
+};
+
+}
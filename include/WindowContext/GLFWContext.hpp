@@ -1,48 +1,71 @@
 #pragma once
 
-#include "IWindowContext.hpp"
+#include "WindowContextBase.hpp"
 #include <GLFW/glfw3.h>
-#include <atomic>
-#include <thread>
-#include <stdexcept>
+#include <memory>
+#include <string>
 
 namespace io {
 
-class GLFWContext : public IWindowContext {
+// Who runs the GLFW event loop, fixed when the first window is created.
+// Latency is from the OS delivering input to the handler running.
+enum class PumpMode {
+    // update() calls glfwPollEvents(). Latency: up to one update() period.
+    // CPU: whatever the caller's loop costs; it must pace itself.
+    poll,
+    // update() blocks in glfwWaitEventsTimeout() until input or the frame
+    // deadline. Latency: the OS wakeup, typically tens of microseconds. Idle
+    // CPU: one wakeup per frame interval, none with an interval of 0.
+    wait_deadline,
+    // A pump thread blocks in glfwWaitEvents() and wakes update(), which
+    // waits for it or the frame deadline. Latency: the OS wakeup plus one
+    // thread handoff, about 6us p50 and 12us p99 on Linux (pump/wake_latency
+    // in io_bench). Idle CPU: as for wait_deadline. GLFW documents its event
+    // functions as main thread only; this works on X11, Wayland and Windows
+    // but not on macOS.
+    thread
+};
+
+// One GLFW window and its input. Any number can exist at once; they share one
+// event pump, and each keeps its callback state in its own cache-line aligned
+// block reached through the window user pointer. With a main-thread pump
+// mode, update() every window from the thread that created them. Gamepads
+// are polled by the pump and reach every focused window that handles them.
+class GLFWContext : public WindowContextBase {
+    class Pump;
+    struct WindowState;
+    struct Callbacks;
+
+    std::shared_ptr<Pump> pump;
+    std::unique_ptr<WindowState> state;
     GLFWwindow* window{nullptr};
-    std::thread t;
-    std::atomic_bool running{false};
-    struct Dispatcher;
 
-    void input_listener_thread_fn();
-    GLFWContext();
+    void request_callbacks(uint32_t types);
+public:
+    explicit GLFWContext(int width = 640, int height = 480, const std::string& title = "Hello World",
+                         PumpMode mode = PumpMode::thread);
     ~GLFWContext();
     GLFWContext(const GLFWContext&) = delete;
-    GLFWContext operator=(const GLFWContext&) = delete;
-    std::tuple<int, int> get_dimensions_();
-public:
-    static IWindowContext& get();
-
-    void set_key_input_listener(IKeyInputListener* il) override;
-    void set_cursor_position_listener(ICursorPositionListener* pl) override;
-    void set_mouse_movement_listener(IMouseMovementListener* ml) override;
-    void set_mouse_input_listener(IMouseInputListener* il) override;
-    void set_window_resized_listener(IWindowResizeListener* il) override;
-    void set_character_listener(ICharacterInputListener* cl) override;
-    void set_scroll_input_listener(IScrollIuputListener *sl) override;
-
-    void set_key_input_callback(std::function<void(int, int, int)>) override;
-    void set_cursor_position_callback(std::function<void(double, double)>) override;
-    void set_mouse_movement_callback(std::function<void(double, double)>) override;
-    void set_mouse_input_callback(std::function<void(int, int, int)>) override;
-    void set_window_resized_callback(std::function<void(int, int)>) override;
-    void set_character_callback(std::function<void(uint32_t)>) override;
-    void set_scroll_input_callback(std::function<void (double, double)>) override;
+    GLFWContext& operator=(const GLFWContext&) = delete;
+
+    static constexpr uint64_t default_gamepad_poll_interval = 1'000'000;
+
+    // How often the shared pump reads the pads while a gamepad is connected
+    // and any window handles gamepad events or tracks state; pads are also
+    // read after every other wakeup. With no pad connected the pump only
+    // waits for events.
+    void set_gamepad_poll_interval(uint64_t interval_ns);
 
     void set_cursor_mode(bool val) override;
     void set_sticky_keys(bool val) override;
+    size_t paste_clipboard() override;
     bool update() override;
+    MotionStats get_motion_stats() override;
     std::tuple<int, int> get_dimensions() override;
+
+    GLFWwindow* get_window() const {
+        return window;
+    }
 };
 
 }
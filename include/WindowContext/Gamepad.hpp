@@ -0,0 +1,110 @@
+#pragma once
+#include "InputEvent.hpp"
+#include "InputState.hpp"
+#include <array>
+#include <atomic>
+
+namespace io {
+
+// How a raw axis position becomes the reported one: travel within
+// `deadzone` of rest reads as rest, the remainder is rescaled to the full
+// range and bent by `curve`, from 0 (linear) to 1 (cubic).
+struct GamepadResponse {
+    float deadzone{0.1f};
+    float curve{0.0f};
+};
+
+// Raw state of every pad as GLFW reports it: sticks -1 to 1, triggers -1 at
+// rest to 1. Axes are stored axis-major so that one axis of all pads is a
+// contiguous row for the vector pass.
+struct GamepadReadings {
+    static constexpr size_t pad_count = InputState::gamepad_count;
+    static constexpr size_t axis_count = GamepadState::axis_count;
+    static constexpr size_t stick_axis_count = 4;  // then the two triggers
+
+    uint16_t connected{0};
+    std::array<uint16_t, pad_count> buttons{};
+    alignas(64) float axes[axis_count][pad_count];
+
+    GamepadReadings();
+    // `buttons` has bit n set while button n is held.
+    void set(int pad, uint16_t buttons, const float* axes);
+    // Disconnected: released, sticks centered, triggers at rest.
+    void clear(int pad);
+};
+
+// Turns successive readings into gamepad events. The responses are applied
+// to all axes of all pads in one SIMD pass, which also compares the result
+// with the previous one, and only differences are emitted. update() and
+// release() belong to the thread polling the pads; the responses may be set
+// from any thread.
+class GamepadPoller {
+    static constexpr size_t pad_count = GamepadReadings::pad_count;
+    static constexpr size_t axis_count = GamepadReadings::axis_count;
+
+    std::atomic<GamepadResponse> stick_response{GamepadResponse{}};
+    std::atomic<GamepadResponse> trigger_response{GamepadResponse{0.05f, 0.0f}};
+    uint16_t connected{0};
+    std::array<uint16_t, pad_count> buttons{};
+    alignas(64) float axes[axis_count][pad_count]{};
+    alignas(64) float filtered[axis_count][pad_count];
+
+    // Fills `filtered` from `r`; bit p of moved[a] is set when axis a of pad
+    // p differs from `axes`.
+    void filter(const GamepadReadings& r, std::array<uint16_t, axis_count>& moved);
+
+    template<typename FN>
+    static void for_each_bit(uint32_t bits, FN&& fn) {
+        while(bits) {
+            fn(__builtin_ctz(bits));
+            bits &= bits - 1;
+        }
+    }
+public:
+    // Throws std::invalid_argument unless 0 <= deadzone < 1 and 0 <= curve <= 1.
+    void set_stick_response(const GamepadResponse& r);
+    void set_trigger_response(const GamepadResponse& r);
+
+    // Passes every change since the previous call to fn(const InputEvent&),
+    // stamped with `timestamp`: new pads, buttons, axes, then pads that went
+    // away, whose buttons and axes were released just before. Returns the
+    // number of events.
+    template<typename FN>
+    size_t update(const GamepadReadings& r, uint64_t timestamp, FN&& fn) {
+        std::array<uint16_t, axis_count> moved;
+        filter(r, moved);
+        size_t n = 0;
+        auto emit = [&](InputEvent e) {
+            e.timestamp = timestamp;
+            fn(e);
+            ++n;
+        };
+        for_each_bit(r.connected & ~connected, [&](int pad) {
+            emit(InputEvent::make_gamepad_connection(pad, true));
+        });
+        for(size_t pad = 0; pad < pad_count; ++pad) {
+            uint16_t now = r.buttons[pad];
+            for_each_bit(now ^ buttons[pad], [&](int b) {
+                emit(InputEvent::make_gamepad_button(static_cast<int>(pad), b, now >> b & 1));
+            });
+            buttons[pad] = now;
+        }
+        for(size_t a = 0; a < axis_count; ++a) {
+            for_each_bit(moved[a], [&](int pad) {
+                axes[a][pad] = filtered[a][pad];
+                emit(InputEvent::make_gamepad_axis(pad, static_cast<int>(a), filtered[a][pad]));
+            });
+        }
+        for_each_bit(connected & ~r.connected, [&](int pad) {
+            emit(InputEvent::make_gamepad_connection(pad, false));
+        });
+        connected = r.connected;
+        return n;
+    }
+
+    // Forgets held buttons and axis positions, so the next update() reports
+    // them again, e.g. after the window regains focus.
+    void release();
+};
+
+}
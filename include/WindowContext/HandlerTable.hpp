@@ -0,0 +1,160 @@
+#pragma once
+#include "Counters.hpp"
+#include "Delegate.hpp"
+#include "EpochReclaimer.hpp"
+#include "EventFilter.hpp"
+#include "InputEvent.hpp"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <variant>
+#include <vector>
+
+namespace io {
+
+// Returns true when the event is consumed and must not reach lower priorities.
+using EventHandler = Delegate<bool(const InputEvent&)>;
+using InputEventCallback = Delegate<void(const InputEvent&)>;
+using CharactersInputCallback = Delegate<void(const uint32_t*, size_t)>;
+using CharacterInputCallback = Delegate<void(uint32_t)>;
+using DrainCallback = Delegate<void()>;
+// A set_*_callback callback, kept in its slot and called with the event's
+// fields: key and mouse input, positions and deltas, or sizes.
+using SlotCallback = std::variant<std::monostate, Delegate<void(int, int, int)>,
+                                  Delegate<void(double, double)>, Delegate<void(int, int)>>;
+
+struct SubscriptionToken {
+    EventType type;
+    uint64_t id;
+};
+
+// Where a subscribed handler runs.
+enum class ListenerAffinity {
+    // On the thread producing the event (the pump thread in PumpMode::thread)
+    // before it is queued. Returning true keeps the event off the queue, so
+    // it is neither recorded nor delivered to other affinities.
+    inline_,
+    // In drain_events()/update(), in priority order with the listener slots.
+    main_thread,
+    // On the library's worker pool, in order per subscription, from a copy
+    // posted at the handler's place in the main thread order. It cannot
+    // consume the event.
+    executor
+};
+
+// Main thread and inline handlers are timed on one dispatch in
+// HandlerTable::timing_period, so their total is an estimate and their max
+// the largest sampled call; executor handlers are timed on every call.
+struct ListenerStats {
+    SubscriptionToken token;  // listener slots have id == type
+    ListenerAffinity affinity;
+    uint64_t calls;
+    uint64_t total_ns;
+    uint64_t max_ns;
+};
+
+// Backlog of one executor subscription.
+struct ListenerQueueStats {
+    SubscriptionToken token;
+    size_t depth;           // events posted and not yet handled
+    size_t high_watermark;
+    uint64_t delivered;
+};
+
+// Per event type, a contiguous array of handlers sorted by descending
+// priority (subscription order among equals). Lists are copied on write and
+// published through the reclaimer, so dispatch walks them without locking.
+// Counts travel with the copy; calls made while a list is being replaced
+// may go uncounted.
+class HandlerTable {
+public:
+    static constexpr uint32_t timing_period = 256;
+private:
+    struct Entry {
+        EventHandler handler;  // empty for a slot callback
+        SlotCallback slot{};
+        bool filtered{false};
+        EventFilter filter{};
+        // Calls are not counted one by one: they are base_calls plus the
+        // list's dispatches, less the events the filter rejected and those
+        // consumed by a handler ahead of this one.
+        mutable RelaxedCounter base_calls, rejected, consumed;
+        mutable TimingCounters timing;  // of the timed dispatches
+        int priority{0};
+        uint64_t id{0};
+        // Timed by whoever runs the real handler, e.g. an executor worker.
+        std::shared_ptr<ListenerCounters> external{};
+
+        bool call(const InputEvent& e) const {
+            if(handler)
+                return handler(e);
+            call_slot(slot, e);
+            return false;
+        }
+    };
+    struct List {
+        std::vector<Entry> entries;
+        mutable RelaxedCounter dispatches;
+    };
+
+    std::array<EpochSlot<List>, event_type_count> lists;
+    mutable std::mutex mutex;
+    uint64_t next_id;
+    mutable uint32_t untimed{timing_period - 1};  // dispatching thread; times the first
+
+    template<typename FN>
+    void modify(EpochReclaimer& reclaimer, EventType type, FN&& fn);
+    static void insert(std::vector<Entry>& entries, Entry e);
+    static void call_slot(const SlotCallback& slot, const InputEvent& e);
+    void replace_slot(EpochReclaimer& reclaimer, EventType type, Entry e, bool set);
+    static std::vector<uint64_t> calls(const List& list);
+    bool dispatch_timed(const List& list, const InputEvent& e) const;
+public:
+    // Tokens get ids from `first_id` up, so tables can tell theirs apart.
+    explicit HandlerTable(uint64_t first_id = event_type_count) : next_id(first_id) {}
+
+    // `external` is for handlers that forward the event and time the real
+    // work elsewhere; by default the table times the handler itself.
+    SubscriptionToken subscribe(EpochReclaimer& reclaimer, EventType type,
+                                EventHandler handler, int priority, const EventFilter& filter = {},
+                                std::shared_ptr<ListenerCounters> external = nullptr);
+    bool unsubscribe(EpochReclaimer& reclaimer, SubscriptionToken token);
+
+    // Replaces the single handler owned by the set_*_listener/set_*_callback
+    // setters of `type`; it runs at priority 0 and never consumes.
+    void set_slot(EpochReclaimer& reclaimer, EventType type, EventHandler handler);
+    void set_slot(EpochReclaimer& reclaimer, EventType type, SlotCallback callback);
+
+    // Adds every handler and its filter to `b`.
+    void add_interest(EventAdmission::Builder& b);
+    // Appends the execution time of every handler; forwarders report
+    // `external_affinity`.
+    void add_listener_stats(std::vector<ListenerStats>& out, ListenerAffinity affinity,
+                            ListenerAffinity external_affinity) const;
+
+    // Caller must hold an EpochReclaimer::Guard. Only the timed dispatches
+    // read the clock, once per handler.
+    bool dispatch(const InputEvent& e) const {
+        auto list = lists[static_cast<size_t>(e.type)].load();
+        if(!list)
+            return false;
+        list->dispatches.add();
+        if(++untimed == timing_period) {
+            untimed = 0;
+            return dispatch_timed(*list, e);
+        }
+        for(auto& entry : list->entries) {
+            if(entry.filtered && !entry.filter.matches(e)) {
+                entry.rejected.add();
+                continue;
+            }
+            if(entry.call(e)) {
+                entry.consumed.add();
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "WindowContextBase.hpp"
+#include "SyntheticInput.hpp"
+#include <memory>
+#include <vector>
+
+namespace io {
+
+// Window context without a display. Events come from inject(), from the
+// attached generators and from the pads set with set_gamepad(), and go
+// through the same queue, state tracking and dispatch as GLFWContext. Cursor
+// positions are turned into mouse movement outside cursor mode and resizes
+// update get_dimensions(), as a window would.
+// inject() and update() produce events, so call them from the same thread.
+class HeadlessContext : public WindowContextBase {
+    std::vector<std::unique_ptr<IEventGenerator>> generators;
+    GamepadReadings pads;
+    RelativeMotion relative_motion;
+    bool cursor_mode{false};
+    bool closed{false};
+    std::string clipboard;
+    int width, height;
+
+    void produce(const InputEvent& e);
+public:
+    explicit HeadlessContext(int width = 640, int height = 480,
+                             size_t event_queue_capacity = default_event_queue_capacity);
+
+    // Queues `e`; a zero timestamp is replaced with the current time.
+    void inject(InputEvent e);
+    // Queues a sequence and publishes the input state once, like one pump pass.
+    void inject(const InputEvent* first, size_t count);
+    // What update() reads from pad `pad` until changed, in GLFW's ranges;
+    // bit n of `buttons` holds button n. update() emits the differences.
+    void set_gamepad(int pad, uint16_t buttons, const std::array<float, GamepadState::axis_count>& axes);
+    void remove_gamepad(int pad);
+    void add_generator(std::unique_ptr<IEventGenerator> generator);
+    void clear_generators();
+    // Makes the next update() return false, like closing a window.
+    void close() {
+        closed = true;
+    }
+
+    void set_cursor_mode(bool val) override;
+    void set_sticky_keys(bool) override {}
+    size_t paste_clipboard() override {
+        return paste_text(clipboard);
+    }
+    void set_clipboard_string(std::string utf8) {
+        clipboard = std::move(utf8);
+    }
+    bool update() override;
+    MotionStats get_motion_stats() override {
+        return relative_motion.stats();
+    }
+    std::tuple<int, int> get_dimensions() override {
+        return {width, height};
+    }
+};
+
+}
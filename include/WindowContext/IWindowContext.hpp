@@ -1,7 +1,17 @@
 #pragma once
 #include <cinttypes>
 #include <tuple>
-#include <functional>
+#include "Delegate.hpp"
+#include <string>
+#include <vector>
+#include "HandlerTable.hpp"
+#include "EventQueue.hpp"
+#include "Gamepad.hpp"
+#include "InputEvent.hpp"
+#include "InputState.hpp"
+#include "InputStats.hpp"
+#include "LatencyHistogram.hpp"
+#include "RelativeMotion.hpp"
 
 namespace io {
 
@@ -38,6 +48,11 @@ public:
 class ICharacterInputListener {
 public:
     virtual void serve_character(uint32_t codepoint) = 0;
+    // Consecutive characters of one drain, or a whole paste, in one call.
+    virtual void serve_characters(const uint32_t* codepoints, size_t count) {
+        for(size_t i = 0; i < count; ++i)
+            serve_character(codepoints[i]);
+    }
     ~ICharacterInputListener() = default;
 };
 
@@ -47,6 +62,19 @@ public:
     ~IScrollIuputListener() = default;
 };
 
+class IInputEventListener {
+public:
+    virtual void serve_input_event(const InputEvent& e) = 0;
+    ~IInputEventListener() = default;
+};
+
+using KeyInputCallback = Delegate<void(int, int, int)>;
+using CursorPositionCallback = Delegate<void(double, double)>;
+using MouseMovementCallback = Delegate<void(double, double)>;
+using MouseInputCallback = Delegate<void(int, int, int)>;
+using WindowResizeCallback = Delegate<void(int, int)>;
+using ScrollInputCallback = Delegate<void(double, double)>;
+
 class IWindowContext {
 public:
     virtual void set_key_input_listener(IKeyInputListener* il) = 0;
@@ -56,20 +84,87 @@ public:
     virtual void set_window_resized_listener(IWindowResizeListener* il) = 0;
     virtual void set_character_listener(ICharacterInputListener* cl) = 0;
     virtual void set_scroll_input_listener(IScrollIuputListener* sl) = 0;
+    // Sees every delivered event, with its timestamp, before the typed listener.
+    virtual void set_input_event_listener(IInputEventListener* el) = 0;
+
+    virtual void set_key_input_callback(KeyInputCallback) = 0;
+    virtual void set_cursor_position_callback(CursorPositionCallback) = 0;
+    virtual void set_mouse_movement_callback(MouseMovementCallback) = 0;
+    virtual void set_mouse_input_callback(MouseInputCallback) = 0;
+    virtual void set_window_resized_callback(WindowResizeCallback) = 0;
+    virtual void set_character_callback(CharacterInputCallback) = 0;
+    virtual void set_scroll_input_callback(ScrollInputCallback) = 0;
+    // Batched form of set_character_callback; both share one slot.
+    virtual void set_characters_callback(CharactersInputCallback) = 0;
+    virtual void set_input_event_callback(InputEventCallback) = 0;
+    // Runs on the consumer thread at the end of every drain_events(), e.g.
+    // to resume work waiting on a timeout.
+    virtual void set_drain_callback(DrainCallback) = 0;
+    // Drain callbacks for any number of users, e.g. coroutine schedulers; they
+    // run in the order added, before the set_drain_callback one.
+    virtual uint64_t add_drain_callback(DrainCallback) = 0;
+    virtual bool remove_drain_callback(uint64_t id) = 0;
+
+    // Handlers of one affinity run in descending priority; returning true
+    // stops propagation. The set_*_listener/set_*_callback slot of each type
+    // sits at main thread priority 0. Unsubscribing an executor handler waits
+    // for it to return unless called from the handler.
+    // Events that no handler wants, by type or `filter`, are dropped before
+    // they are queued, and backends stop listening for types nobody handles.
+    virtual SubscriptionToken subscribe(EventType type, EventHandler handler, int priority = 0,
+                                        ListenerAffinity affinity = ListenerAffinity::main_thread,
+                                        const EventFilter& filter = {}) = 0;
+    virtual bool unsubscribe(SubscriptionToken token) = 0;
+    virtual std::vector<ListenerQueueStats> get_listener_queue_stats() = 0;
+
+    // Streams every drained event, before coalescing, to an EventRecorder log.
+    virtual void start_recording(const std::string& path) = 0;
+    virtual void stop_recording() = 0;
 
-    virtual void set_key_input_callback(std::function<void(int, int, int)>) = 0;
-    virtual void set_cursor_position_callback(std::function<void(double, double)>) = 0;
-    virtual void set_mouse_movement_callback(std::function<void(double, double)>) = 0;
-    virtual void set_mouse_input_callback(std::function<void(int, int, int)>) = 0;
-    virtual void set_window_resized_callback(std::function<void(int, int)>) = 0;
-    virtual void set_character_callback(std::function<void(uint32_t)>) = 0;
-    virtual void set_scroll_input_callback(std::function<void(double, double)>) = 0;
+    // Delivers UTF-8 text to the character listener/callback as one batch,
+    // as if typed, and to the event log when recording. Consumer thread only.
+    virtual size_t paste_text(const std::string& utf8) = 0;
+    // paste_text() with the system clipboard; returns the codepoints pasted.
+    virtual size_t paste_clipboard() = 0;
 
     virtual void set_sticky_keys(bool val) = 0;
     virtual void set_cursor_mode(bool val) = 0;
+    // Deliver at most one cursor position, mouse movement and scroll event per
+    // drain, summing relative deltas and keeping the latest position.
+    virtual void set_motion_coalescing(bool val) = 0;
+    // update() returns at the next frame deadline, one interval after the
+    // previous one, or earlier when the backend sees input. 0 removes the
+    // deadline: GLFW then waits for input alone and other backends do not wait.
+    virtual void set_frame_interval(uint64_t interval_ns) = 0;
+    // Deadzone and curve of the gamepad sticks and triggers, for backends
+    // that poll pads. Pads are polled while a gamepad is connected and
+    // anything handles gamepad events or state tracking is on.
+    virtual void set_gamepad_response(const GamepadResponse& sticks, const GamepadResponse& triggers) = 0;
     virtual bool update() = 0;
+    // Delivers every event queued by the window event pump to the listeners on
+    // the calling thread. update() drains as well; use one consumer thread.
+    virtual size_t drain_events() = 0;
+    // Off by default. While on, keys, buttons, motion and gamepads are folded
+    // into the input state whether or not anything listens to them.
+    virtual void set_state_tracking(bool val) = 0;
+    // Snapshot acquired by the last drain_events(); it stays unchanged until
+    // the next one, so it can be shared by every system of a frame.
+    virtual const InputState& get_input_state() = 0;
+    // Off by default. While on, with state tracking, cursor positions and
+    // relative motion are extrapolated from their callback timestamps; query
+    // with InputState::predict_cursor()/predict_motion().
+    virtual void set_motion_prediction(bool val, const PredictionConfig& config = {}) = 0;
+    virtual EventQueueStats get_event_queue_stats() = 0;
+    virtual MotionStats get_motion_stats() = 0;
+    virtual LatencySnapshot get_latency_snapshot() = 0;
+    virtual void reset_latency_histograms() = 0;
+    // Always-on counters per event type and listener, from any thread.
+    virtual InputStats stats() = 0;
+    // Hands stats() to `sink` from update()/drain_events() at most every
+    // `period_ns`; write_stats() formats them. A null sink stops it.
+    virtual void set_stats_sink(StatsSink sink, uint64_t period_ns) = 0;
     virtual std::tuple<int, int> get_dimensions() = 0;
-    ~IWindowContext() = default;
+    virtual ~IWindowContext() = default;
 };
 
 }
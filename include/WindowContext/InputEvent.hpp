@@ -0,0 +1,128 @@
+#pragma once
+#include <cinttypes>
+#include <cstddef>
+#include <chrono>
+
+namespace io {
+
+inline uint64_t monotonic_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+enum class EventType : uint8_t {
+    key_input,
+    cursor_position,
+    mouse_movement,
+    mouse_input,
+    window_resize,
+    character,
+    scroll_input,
+    gamepad_connection,
+    gamepad_button,
+    gamepad_axis,
+    count
+};
+
+constexpr size_t event_type_count = static_cast<size_t>(EventType::count);
+
+struct KeyEvent {
+    int key, action, mods;
+};
+
+struct PositionEvent {
+    double x, y;
+};
+
+struct ButtonEvent {
+    int button, action, mods;
+};
+
+struct SizeEvent {
+    int width, height;
+};
+
+// pad is 0-15 (GLFW_JOYSTICK_1 + pad). Buttons: code is the GLFW gamepad
+// button, action GLFW_PRESS/GLFW_RELEASE. Axes: code is the GLFW gamepad
+// axis, value the filtered position, -1 to 1 for sticks and 0 to 1 for
+// triggers. Connections: action is 1 when the pad appears, 0 when it goes.
+struct GamepadEvent {
+    int pad, code, action;
+    float value;
+};
+
+struct InputEvent {
+    EventType type;
+    uint64_t timestamp{0};  // monotonic_ns() at GLFW callback time
+    union {
+        KeyEvent key;
+        PositionEvent position;
+        ButtonEvent button;
+        SizeEvent size;
+        uint32_t codepoint;
+        GamepadEvent gamepad;
+    };
+
+    static InputEvent make_key_input(int key, int action, int mods) {
+        InputEvent e;
+        e.type = EventType::key_input;
+        e.key = {key, action, mods};
+        return e;
+    }
+    static InputEvent make_cursor_position(double x, double y) {
+        InputEvent e;
+        e.type = EventType::cursor_position;
+        e.position = {x, y};
+        return e;
+    }
+    static InputEvent make_mouse_movement(double dx, double dy) {
+        InputEvent e;
+        e.type = EventType::mouse_movement;
+        e.position = {dx, dy};
+        return e;
+    }
+    static InputEvent make_mouse_input(int button, int action, int mods) {
+        InputEvent e;
+        e.type = EventType::mouse_input;
+        e.button = {button, action, mods};
+        return e;
+    }
+    static InputEvent make_window_resize(int width, int height) {
+        InputEvent e;
+        e.type = EventType::window_resize;
+        e.size = {width, height};
+        return e;
+    }
+    static InputEvent make_character(uint32_t codepoint) {
+        InputEvent e;
+        e.type = EventType::character;
+        e.codepoint = codepoint;
+        return e;
+    }
+    static InputEvent make_scroll_input(double dx, double dy) {
+        InputEvent e;
+        e.type = EventType::scroll_input;
+        e.position = {dx, dy};
+        return e;
+    }
+    static InputEvent make_gamepad_connection(int pad, bool connected) {
+        InputEvent e;
+        e.type = EventType::gamepad_connection;
+        e.gamepad = {pad, 0, connected, 0.0f};
+        return e;
+    }
+    static InputEvent make_gamepad_button(int pad, int button, int action) {
+        InputEvent e;
+        e.type = EventType::gamepad_button;
+        e.gamepad = {pad, button, action, action ? 1.0f : 0.0f};
+        return e;
+    }
+    static InputEvent make_gamepad_axis(int pad, int axis, float value) {
+        InputEvent e;
+        e.type = EventType::gamepad_axis;
+        e.gamepad = {pad, axis, 0, value};
+        return e;
+    }
+};
+
+}
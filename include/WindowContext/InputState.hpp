@@ -0,0 +1,165 @@
+#pragma once
+#include "MotionPredictor.hpp"
+#include "TripleBuffer.hpp"
+#include <array>
+#include <bitset>
+#include <cinttypes>
+
+namespace io {
+
+// Polled view of the input devices. Level state (held keys and buttons,
+// cursor, modifiers) is the latest known; edges and accumulated deltas cover
+// everything since the previously acquired snapshot, so nothing is lost when
+// the pump publishes several times per frame.
+struct GamepadState {
+    static constexpr size_t button_count = 15;  // GLFW_GAMEPAD_BUTTON_LAST + 1
+    static constexpr size_t axis_count = 6;     // GLFW_GAMEPAD_AXIS_LAST + 1
+
+    uint16_t buttons{0}, buttons_pressed{0}, buttons_released{0};
+    std::array<float, axis_count> axes{};  // filtered, as in GamepadEvent
+
+    bool button_down(int button) const {
+        return valid_button(button) && (buttons >> button) & 1;
+    }
+    bool button_pressed(int button) const {
+        return valid_button(button) && (buttons_pressed >> button) & 1;
+    }
+    bool button_released(int button) const {
+        return valid_button(button) && (buttons_released >> button) & 1;
+    }
+    float axis(int axis) const {
+        return axis >= 0 && static_cast<size_t>(axis) < axis_count ? axes[axis] : 0.0f;
+    }
+
+    static bool valid_button(int button) {
+        return button >= 0 && static_cast<size_t>(button) < button_count;
+    }
+};
+
+struct InputState {
+    static constexpr size_t key_count = 512;
+    static constexpr size_t button_count = 8;
+    static constexpr size_t gamepad_count = 16;  // GLFW_JOYSTICK_LAST + 1
+
+    std::bitset<key_count> keys, keys_pressed, keys_released;
+    uint8_t buttons{0}, buttons_pressed{0}, buttons_released{0};
+    int mods{0};
+    double cursor_x{0}, cursor_y{0};
+    double motion_dx{0}, motion_dy{0};
+    double scroll_dx{0}, scroll_dy{0};
+    uint16_t gamepads_connected{0};  // bit n: pad n
+    std::array<GamepadState, gamepad_count> gamepads{};
+    // With motion prediction on; timestamp 0 otherwise.
+    MotionEstimate cursor_estimate, motion_estimate;
+    uint64_t timestamp{0};  // monotonic_ns() of the last event folded in
+    uint64_t sequence{0};   // incremented by every publication
+
+    bool key_down(int key) const {
+        return valid_key(key) && keys.test(key);
+    }
+    bool key_pressed(int key) const {
+        return valid_key(key) && keys_pressed.test(key);
+    }
+    bool key_released(int key) const {
+        return valid_key(key) && keys_released.test(key);
+    }
+    bool button_down(int button) const {
+        return valid_button(button) && (buttons >> button) & 1;
+    }
+    bool button_pressed(int button) const {
+        return valid_button(button) && (buttons_pressed >> button) & 1;
+    }
+    bool button_released(int button) const {
+        return valid_button(button) && (buttons_released >> button) & 1;
+    }
+    // Cursor position extrapolated to `target`, a monotonic_ns() time such
+    // as the next vsync; the latest position without motion prediction.
+    std::tuple<double, double> predict_cursor(uint64_t target) const {
+        if(!cursor_estimate.timestamp)
+            return {cursor_x, cursor_y};
+        return cursor_estimate.predict(target);
+    }
+    // Relative motion expected between the latest mouse movement and
+    // `target`, on top of what has been delivered.
+    std::tuple<double, double> predict_motion(uint64_t target) const {
+        if(!motion_estimate.timestamp)
+            return {0.0, 0.0};
+        return motion_estimate.lead(target);
+    }
+    bool gamepad_connected(int pad) const {
+        return valid_gamepad(pad) && (gamepads_connected >> pad) & 1;
+    }
+    // A disconnected pad reads as released and centered.
+    const GamepadState& gamepad(int pad) const {
+        static const GamepadState none;
+        return valid_gamepad(pad) ? gamepads[pad] : none;
+    }
+
+    void clear_edges() {
+        keys_pressed.reset();
+        keys_released.reset();
+        buttons_pressed = buttons_released = 0;
+        motion_dx = motion_dy = scroll_dx = scroll_dy = 0;
+        for(auto& g : gamepads)
+            g.buttons_pressed = g.buttons_released = 0;
+    }
+
+    static bool valid_key(int key) {
+        return key >= 0 && static_cast<size_t>(key) < key_count;
+    }
+    static bool valid_button(int button) {
+        return button >= 0 && static_cast<size_t>(button) < button_count;
+    }
+    static bool valid_gamepad(int pad) {
+        return pad >= 0 && static_cast<size_t>(pad) < gamepad_count;
+    }
+};
+
+// Folds events into an InputState on the pump thread and publishes it through
+// a triple buffer. All methods except acquire() and snapshot() belong to the
+// producer; those two belong to the consumer.
+class InputStateTracker {
+    struct Edges {
+        std::bitset<InputState::key_count> keys_pressed, keys_released;
+        uint8_t buttons_pressed{0}, buttons_released{0};
+        double motion_dx{0}, motion_dy{0};
+        double scroll_dx{0}, scroll_dy{0};
+        std::array<uint16_t, InputState::gamepad_count> pad_pressed{}, pad_released{};
+
+        void merge(const Edges& o);
+    };
+
+    TripleBuffer<InputState> buffers;
+    InputState levels;
+    Edges pending, published;
+    bool dirty{false};
+    bool predicting{false};
+    MotionPredictor cursor_predictor, motion_predictor;
+    double motion_x{0}, motion_y{0};  // relative motion summed for its predictor
+public:
+    void key(int key, int action, int mods, uint64_t timestamp);
+    void button(int button, int action, int mods, uint64_t timestamp);
+    void cursor(double x, double y, uint64_t timestamp);
+    void motion(double dx, double dy, uint64_t timestamp);
+    void scroll(double dx, double dy, uint64_t timestamp);
+    void gamepad_connection(int pad, bool connected, uint64_t timestamp);
+    void gamepad_button(int pad, int button, int action, uint64_t timestamp);
+    void gamepad_axis(int pad, int axis, float value, uint64_t timestamp);
+    // Releases every held key and button and centers every gamepad axis,
+    // e.g. when the window loses focus.
+    void release_all(uint64_t timestamp);
+    // Feeds cursor positions and summed relative motion to predictors whose
+    // estimates are published with the state.
+    void set_prediction(bool val, const PredictionConfig& config);
+
+    void publish();
+
+    // Moves snapshot() to the latest publication; without one, only the
+    // edges and deltas of the previous frame are cleared.
+    bool acquire();
+    const InputState& snapshot() const {
+        return buffers.front();
+    }
+};
+
+}
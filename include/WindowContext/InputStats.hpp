@@ -0,0 +1,33 @@
+#pragma once
+#include "EventQueue.hpp"
+#include "HandlerTable.hpp"
+#include <array>
+#include <ostream>
+#include <vector>
+
+namespace io {
+
+struct EventTypeStats {
+    uint64_t received;   // reached the dispatcher from the backend
+    uint64_t filtered;   // dropped before queueing: no handler wanted them
+    uint64_t unfocused;  // dropped by the backend while the window was unfocused
+    uint64_t delivered;  // handed to handlers, after coalescing
+};
+
+struct InputStats {
+    uint64_t timestamp;
+    std::array<EventTypeStats, event_type_count> types;
+    EventQueueStats queue;
+    uint64_t wakeups;  // times the backend woke up to look for input
+    double wakeups_per_second;
+    std::vector<ListenerStats> listeners;
+    std::vector<ListenerQueueStats> listener_queues;
+};
+
+using StatsSink = Delegate<void(const InputStats&)>;
+
+const char* event_type_name(EventType type);
+// One line per type, listener and listener queue, for logs.
+void write_stats(std::ostream& out, const InputStats& stats);
+
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "InputEvent.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+namespace io {
+
+struct LatencyPercentiles {
+    uint64_t count;
+    uint64_t p50, p99, p999, max;  // nanoseconds
+};
+
+// Log-linear histogram of nanosecond durations: eight buckets per power of
+// two, so a reported percentile is at most 12.5% above the true value.
+// record() is meant for a single writer, reads may come from any thread.
+class LatencyHistogram {
+    static constexpr unsigned sub_bits = 3;
+    static constexpr unsigned sub_count = 1 << sub_bits;
+    static constexpr unsigned max_bits = 40;
+public:
+    static constexpr size_t bucket_count = (max_bits - sub_bits + 1) * sub_count;
+private:
+    std::array<std::atomic_uint64_t, bucket_count> buckets{};
+    std::atomic_uint64_t max{0};
+
+    static size_t index(uint64_t v) {
+        if(v < sub_count)
+            return v;
+        unsigned p = 63 - __builtin_clzll(v);
+        if(p >= max_bits)
+            return bucket_count - 1;
+        return (p - sub_bits + 1) * sub_count + ((v >> (p - sub_bits)) & (sub_count - 1));
+    }
+    static uint64_t upper_bound(size_t i) {
+        if(i < sub_count)
+            return i;
+        uint64_t p = i / sub_count + sub_bits - 1;
+        uint64_t sub = i % sub_count;
+        return ((sub_count + sub + 1) << (p - sub_bits)) - 1;
+    }
+public:
+    void record(uint64_t ns) {
+        auto& b = buckets[index(ns)];
+        b.store(b.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        if(ns > max.load(std::memory_order_relaxed))
+            max.store(ns, std::memory_order_relaxed);
+    }
+
+    void reset() {
+        for(auto& b : buckets)
+            b.store(0, std::memory_order_relaxed);
+        max.store(0, std::memory_order_relaxed);
+    }
+
+    LatencyPercentiles percentiles() const {
+        std::array<uint64_t, bucket_count> counts;
+        uint64_t total = 0;
+        for(size_t i = 0; i < bucket_count; ++i)
+            total += counts[i] = buckets[i].load(std::memory_order_relaxed);
+
+        LatencyPercentiles res{total, 0, 0, 0, max.load(std::memory_order_relaxed)};
+        if(!total)
+            return res;
+        const uint64_t ranks[] = {(total * 500 + 999) / 1000,
+                                  (total * 990 + 999) / 1000,
+                                  (total * 999 + 999) / 1000};
+        uint64_t* out[] = {&res.p50, &res.p99, &res.p999};
+        uint64_t seen = 0;
+        size_t r = 0;
+        for(size_t i = 0; i < bucket_count && r < 3; ++i) {
+            seen += counts[i];
+            while(r < 3 && seen >= ranks[r])
+                *out[r++] = std::min(upper_bound(i), res.max);
+        }
+        return res;
+    }
+};
+
+struct EventLatency {
+    // Event timestamp to its handlers starting. A coalesced motion event
+    // carries its newest sample's timestamp and starts at the flush.
+    LatencyPercentiles queued;
+    LatencyPercentiles listener;  // handlers starting to the last returning
+};
+
+using LatencySnapshot = std::array<EventLatency, event_type_count>;
+
+class LatencyHistograms {
+    std::array<LatencyHistogram, event_type_count> queued, listener;
+public:
+    void record(EventType type, uint64_t queued_ns, uint64_t listener_ns) {
+        auto i = static_cast<size_t>(type);
+        queued[i].record(queued_ns);
+        listener[i].record(listener_ns);
+    }
+
+    void reset() {
+        for(size_t i = 0; i < event_type_count; ++i) {
+            queued[i].reset();
+            listener[i].reset();
+        }
+    }
+
+    LatencySnapshot snapshot() const {
+        LatencySnapshot s;
+        for(size_t i = 0; i < event_type_count; ++i)
+            s[i] = {queued[i].percentiles(), listener[i].percentiles()};
+        return s;
+    }
+};
+
+}
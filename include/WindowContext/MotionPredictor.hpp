@@ -0,0 +1,99 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cinttypes>
+#include <cstddef>
+#include <tuple>
+
+namespace io {
+
+enum class PredictionFilter {
+    // Velocity from the One-Euro filter's smoothed derivative, applied to its
+    // smoothed position: steady at rest, responsive at speed.
+    one_euro,
+    // Least-squares line through the samples of the last fit_window_ns.
+    linear_fit
+};
+
+struct PredictionConfig {
+    PredictionFilter filter{PredictionFilter::one_euro};
+    // One-Euro: position cutoff at rest in Hz, its increase per unit/s of
+    // speed, and the cutoff in Hz of the velocity. Tuned with io_bench's
+    // prediction/ accuracy runs; jittery sensors want a smaller beta.
+    double min_cutoff{1.0};
+    double beta{0.5};
+    double derivative_cutoff{40.0};
+    // Three samples even from a 125 Hz mouse.
+    uint64_t fit_window_ns{16'000'000};
+    // Predictions extrapolate at most this far past the newest sample. A
+    // sample arriving later than this after the previous one restarts the
+    // filter.
+    uint64_t max_horizon_ns{30'000'000};
+};
+
+// Where the pointer was at `timestamp`, smoothed, and how fast it moved.
+struct MotionEstimate {
+    uint64_t timestamp{0};  // of the newest sample; 0 before any
+    double x{0}, y{0};
+    double vx{0}, vy{0};    // units per second
+    double last_x{0}, last_y{0};  // the newest sample as received
+    uint64_t max_horizon{0};
+
+    // Position at `target` (monotonic_ns), with targets past the horizon
+    // clamped to it; the smoothed position for targets in the past.
+    std::tuple<double, double> predict(uint64_t target) const {
+        target = std::min(target, timestamp + max_horizon);
+        double h = target > timestamp ? (target - timestamp) * 1e-9 : 0.0;
+        return {x + vx * h, y + vy * h};
+    }
+    // predict() relative to the newest sample.
+    std::tuple<double, double> lead(uint64_t target) const {
+        auto [px, py] = predict(target);
+        return {px - last_x, py - last_y};
+    }
+};
+
+// Extrapolates a stream of timestamped positions. Keeps a ring of the recent
+// samples with their raw velocities and refreshes estimate() on every add(),
+// so predicting costs two multiply-adds.
+class MotionPredictor {
+public:
+    struct Sample {
+        uint64_t timestamp;
+        double x, y;
+        double vx, vy;  // since the previous sample, units per second
+    };
+    static constexpr size_t history_size = 32;
+private:
+    PredictionConfig config;
+    std::array<Sample, history_size> ring{};
+    size_t head{0}, count{0};
+    double dx{0}, dy{0};  // One-Euro smoothed velocity
+    MotionEstimate current;
+
+    void one_euro(const Sample& s, double dt);
+    void linear_fit();
+public:
+    // Throws std::invalid_argument for non-positive cutoffs or window, or a
+    // negative beta.
+    static void validate(const PredictionConfig& config);
+    explicit MotionPredictor(const PredictionConfig& config = {});
+
+    void configure(const PredictionConfig& config);
+    void add(uint64_t timestamp, double x, double y);
+    // Forgets the history.
+    void reset();
+
+    const MotionEstimate& estimate() const {
+        return current;
+    }
+    size_t size() const {
+        return count;
+    }
+    // age 0 is the newest sample.
+    const Sample& sample(size_t age) const {
+        return ring[(head + history_size - 1 - age) % history_size];
+    }
+};
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cinttypes>
+
+namespace io {
+
+struct MotionStats {
+    uint64_t motion_events;
+    uint64_t warps;
+};
+
+// Turns absolute cursor samples into relative motion. With a disabled cursor
+// and raw mouse motion the delta is taken against the previous sample and the
+// cursor is never moved; otherwise the delta is taken against the window
+// center and the caller has to warp the cursor back there.
+class RelativeMotion {
+    std::atomic_bool warp_free{false};
+    std::atomic_bool needs_reference{true};
+    std::atomic_int center_w{0}, center_h{0};
+    std::atomic_uint64_t motion_events{0}, warps{0};
+    double last_x{0}, last_y{0};
+
+    static void increment(std::atomic_uint64_t& v) {
+        v.store(v.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+public:
+    void set_warp_free(bool val) {
+        warp_free = val;
+        restart();
+    }
+    // Makes the next warp-free sample the reference point again, e.g. after
+    // samples went unobserved.
+    void restart() {
+        needs_reference = true;
+    }
+    bool is_warp_free() const {
+        return warp_free;
+    }
+
+    void set_center(int w, int h) {
+        center_w = w/2;
+        center_h = h/2;
+    }
+    int get_center_w() const {
+        return center_w;
+    }
+    int get_center_h() const {
+        return center_h;
+    }
+
+    // Called from the event pump only. Returns false when the sample just
+    // becomes the new reference point and produces no motion.
+    bool convert(double xpos, double ypos, double& dx, double& dy, bool& warp) {
+        if(warp_free.load(std::memory_order_relaxed)) {
+            warp = false;
+            if(needs_reference.exchange(false, std::memory_order_relaxed)) {
+                last_x = xpos;
+                last_y = ypos;
+                return false;
+            }
+            dx = xpos - last_x;
+            dy = ypos - last_y;
+            last_x = xpos;
+            last_y = ypos;
+        } else {
+            warp = true;
+            dx = xpos - center_w.load(std::memory_order_relaxed);
+            dy = ypos - center_h.load(std::memory_order_relaxed);
+            increment(warps);
+        }
+        increment(motion_events);
+        return true;
+    }
+
+    MotionStats stats() const {
+        return {motion_events.load(std::memory_order_relaxed),
+                warps.load(std::memory_order_relaxed)};
+    }
+};
+
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "WindowContextBase.hpp"
+#include "EventLog.hpp"
+
+namespace io {
+
+enum class ReplaySpeed {
+    recorded,  // events become due at their recorded offsets
+    maximum    // each update() feeds as many events as the queue holds, without
+               // waiting for the frame deadline
+};
+
+// Windowless backend that replays an EventRecorder log through the same
+// dispatch machinery as a live context. Timestamps keep their recorded
+// spacing, shifted to start when the replay does.
+class ReplayContext : public WindowContextBase {
+    EventLogReader reader;
+    ReplaySpeed speed;
+    uint64_t replay_start{0};
+    InputEvent pending;
+    bool has_pending{false};
+    bool finished{false};
+    int width{0}, height{0};
+    uint64_t replayed{0};
+
+    void feed();
+public:
+    explicit ReplayContext(const std::string& path,
+                           ReplaySpeed speed = ReplaySpeed::recorded,
+                           size_t event_queue_capacity = default_event_queue_capacity);
+
+    void set_cursor_mode(bool) override {}
+    void set_sticky_keys(bool) override {}
+    // Pastes made while recording are in the log as character events.
+    size_t paste_clipboard() override {
+        return 0;
+    }
+    // Returns false once the whole log has been delivered.
+    bool update() override;
+    MotionStats get_motion_stats() override {
+        return {};
+    }
+    std::tuple<int, int> get_dimensions() override {
+        return {width, height};
+    }
+
+    void restart();
+    uint64_t get_replayed_events() const {
+        return replayed;
+    }
+};
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "HandlerTable.hpp"
+
+namespace io {
+
+// Source of synthetic events for HeadlessContext. Events are stamped with the
+// time they are due, so a run is reproducible apart from where update() falls.
+class IEventGenerator {
+public:
+    virtual ~IEventGenerator() = default;
+    // Emits every event due at or before `now`. The first call only starts
+    // the clock.
+    virtual void generate(uint64_t now, const InputEventCallback& emit) = 0;
+};
+
+// Bursts of typed letters (key press, character, key release) separated by
+// pauses, like a person typing words.
+class TypingGenerator : public IEventGenerator {
+    uint64_t interval;
+    uint64_t pause;
+    size_t burst_length;
+    size_t typed{0};
+    uint64_t next_due{0};
+    int held_key{-1};  // released at release_due, before the next press
+    uint64_t release_due{0};
+    uint32_t rng;
+public:
+    explicit TypingGenerator(double chars_per_second = 15.0, size_t burst_length = 6,
+                             uint64_t pause_ns = 400'000'000, uint32_t seed = 1);
+    void generate(uint64_t now, const InputEventCallback& emit) override;
+};
+
+// Cursor positions sampled at a fixed rate along a circle, e.g. an 8 kHz
+// gaming mouse moving continuously.
+class MouseGenerator : public IEventGenerator {
+    uint64_t interval;
+    double radius;
+    double radians_per_sample;
+    double center_x, center_y;
+    uint64_t samples{0};
+    uint64_t next_due{0};
+public:
+    explicit MouseGenerator(double rate_hz = 8000.0, double radius = 100.0,
+                            double revolutions_per_second = 1.0,
+                            double center_x = 320.0, double center_y = 240.0);
+    void generate(uint64_t now, const InputEventCallback& emit) override;
+};
+
+// Window resizes at a fixed rate to random sizes, as when a window edge is
+// dragged around.
+class ResizeStormGenerator : public IEventGenerator {
+    uint64_t interval;
+    int min_width, min_height, max_width, max_height;
+    uint64_t next_due{0};
+    uint32_t rng;
+public:
+    explicit ResizeStormGenerator(double rate_hz = 240.0,
+                                  int min_width = 320, int min_height = 240,
+                                  int max_width = 1920, int max_height = 1080,
+                                  uint32_t seed = 1);
+    void generate(uint64_t now, const InputEventCallback& emit) override;
+};
+
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <cinttypes>
+
+namespace io {
+
+// Lock-free triple buffer: the producer fills back() and publishes it, the
+// consumer acquires the most recent publication into front(). The producer
+// learns whether its previous publication was ever acquired, which lets it
+// carry unconsumed edges and deltas into the next one.
+template<typename T>
+class TripleBuffer {
+    static constexpr uint8_t index_mask = 0x3;
+    static constexpr uint8_t fresh_bit = 0x4;
+
+    T buffers[3]{};
+    std::atomic<uint8_t> middle{1};
+    uint8_t back_index{0};
+    uint8_t front_index{2};
+public:
+    T& back() {
+        return buffers[back_index];
+    }
+    const T& front() const {
+        return buffers[front_index];
+    }
+    T& front() {
+        return buffers[front_index];
+    }
+
+    // Producer: observe the shared slot before composing back().
+    uint8_t observe() const {
+        return middle.load(std::memory_order_acquire);
+    }
+    static bool consumed(uint8_t observed) {
+        return !(observed & fresh_bit);
+    }
+    // Producer: publishes back() unless the consumer acquired since observe().
+    bool try_publish(uint8_t observed) {
+        if(!middle.compare_exchange_strong(observed, back_index | fresh_bit,
+                                           std::memory_order_acq_rel))
+            return false;
+        back_index = observed & index_mask;
+        return true;
+    }
+
+    // Consumer: returns false when nothing was published since the last call.
+    bool acquire() {
+        if(consumed(middle.load(std::memory_order_relaxed)))
+            return false;
+        front_index = middle.exchange(front_index, std::memory_order_acq_rel) & index_mask;
+        return true;
+    }
+};
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "InputEvent.hpp"
+#include <condition_variable>
+#include <mutex>
+
+namespace io {
+
+// Wakes a consumer blocked in wait_until() from another thread. A notify()
+// with nobody waiting is remembered until the next wait.
+class Waker {
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool pending{false};
+public:
+    void notify() {
+        {
+            std::lock_guard lock(mutex);
+            pending = true;
+        }
+        cv.notify_one();
+    }
+
+    // Waits until notified or until `deadline` (monotonic_ns(), 0 for none).
+    // Returns false on timeout.
+    bool wait_until(uint64_t deadline) {
+        std::unique_lock lock(mutex);
+        if(!deadline) {
+            cv.wait(lock, [this] { return pending; });
+        } else {
+            auto t = std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline));
+            if(!cv.wait_until(lock, t, [this] { return pending; }))
+                return false;
+        }
+        pending = false;
+        return true;
+    }
+};
+
+}
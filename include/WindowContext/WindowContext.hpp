@@ -0,0 +1,20 @@
+#pragma once
+
+#include "IWindowContext.hpp"
+#include <memory>
+
+namespace io {
+
+enum class WindowBackend {
+    glfw,
+    headless
+};
+
+// A new, independently owned context; GLFW windows open with default size.
+std::unique_ptr<IWindowContext> make_window_context(WindowBackend backend);
+
+// Process-wide window context. The first call creates it with `backend`;
+// later calls return the same context and throw if they ask for another one.
+IWindowContext& get_window_context(WindowBackend backend = WindowBackend::glfw);
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "IWindowContext.hpp"
+#include "EventDispatcher.hpp"
+
+namespace io {
+
+// Listener registration, subscriptions, draining and statistics shared by all
+// backends; a backend only produces events into `events`.
+class WindowContextBase : public IWindowContext {
+protected:
+    EventDispatcher events;
+    GamepadPoller gamepads;
+    uint64_t frame_interval{default_frame_interval};
+    uint64_t frame_deadline{0};
+
+    explicit WindowContextBase(size_t event_queue_capacity);
+    // Deadline of the current frame, on a fixed grid of frame_interval so
+    // that early returns do not shift it; 0 when there is no deadline.
+    uint64_t next_frame_deadline();
+public:
+    static constexpr size_t default_event_queue_capacity = 1 << 14;
+    static constexpr uint64_t default_frame_interval = 1'000'000'000 / 60;
+
+    void set_key_input_listener(IKeyInputListener* il) override;
+    void set_cursor_position_listener(ICursorPositionListener* pl) override;
+    void set_mouse_movement_listener(IMouseMovementListener* ml) override;
+    void set_mouse_input_listener(IMouseInputListener* il) override;
+    void set_window_resized_listener(IWindowResizeListener* il) override;
+    void set_character_listener(ICharacterInputListener* cl) override;
+    void set_scroll_input_listener(IScrollIuputListener *sl) override;
+    void set_input_event_listener(IInputEventListener* el) override;
+
+    void set_key_input_callback(KeyInputCallback) override;
+    void set_cursor_position_callback(CursorPositionCallback) override;
+    void set_mouse_movement_callback(MouseMovementCallback) override;
+    void set_mouse_input_callback(MouseInputCallback) override;
+    void set_window_resized_callback(WindowResizeCallback) override;
+    void set_character_callback(CharacterInputCallback) override;
+    void set_scroll_input_callback(ScrollInputCallback) override;
+    void set_characters_callback(CharactersInputCallback) override;
+    void set_input_event_callback(InputEventCallback) override;
+    void set_drain_callback(DrainCallback) override;
+    uint64_t add_drain_callback(DrainCallback) override;
+    bool remove_drain_callback(uint64_t id) override;
+
+    SubscriptionToken subscribe(EventType type, EventHandler handler, int priority = 0,
+                                ListenerAffinity affinity = ListenerAffinity::main_thread,
+                                const EventFilter& filter = {}) override;
+    bool unsubscribe(SubscriptionToken token) override;
+    std::vector<ListenerQueueStats> get_listener_queue_stats() override;
+
+    void start_recording(const std::string& path) override;
+    void stop_recording() override;
+
+    size_t paste_text(const std::string& utf8) override;
+
+    void set_frame_interval(uint64_t interval_ns) override;
+    void set_gamepad_response(const GamepadResponse& sticks, const GamepadResponse& triggers) override;
+    void set_motion_coalescing(bool val) override;
+    size_t drain_events() override;
+    void set_state_tracking(bool val) override;
+    const InputState& get_input_state() override;
+    void set_motion_prediction(bool val, const PredictionConfig& config = {}) override;
+    EventQueueStats get_event_queue_stats() override;
+    LatencySnapshot get_latency_snapshot() override;
+    void reset_latency_histograms() override;
+    InputStats stats() override;
+    void set_stats_sink(StatsSink sink, uint64_t period_ns) override;
+};
+
+}
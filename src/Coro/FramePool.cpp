@@ -0,0 +1,50 @@
+#include <Coro/FramePool.hpp>
+#include <new>
+
+using namespace io;
+
+FramePool::~FramePool() {
+    for(auto block : free_lists) {
+        while(block) {
+            auto next = block->next;
+            ::operator delete(block);
+            block = next;
+        }
+    }
+}
+
+FramePool& FramePool::local() {
+    thread_local FramePool pool;
+    return pool;
+}
+
+size_t FramePool::size_class(size_t n) {
+    size_t c = 0;
+    while(c < class_count && (min_size << c) < n)
+        ++c;
+    return c;
+}
+
+void* FramePool::allocate(size_t n) {
+    auto c = size_class(n);
+    if(c < class_count) {
+        if(auto block = free_lists[c]) {
+            free_lists[c] = block->next;
+            return block;
+        }
+        n = min_size << c;
+    }
+    ++heap_allocations;
+    return ::operator new(n);
+}
+
+void FramePool::deallocate(void* p, size_t n) {
+    auto c = size_class(n);
+    if(c == class_count) {
+        ::operator delete(p);
+        return;
+    }
+    auto block = static_cast<Block*>(p);
+    block->next = free_lists[c];
+    free_lists[c] = block;
+}
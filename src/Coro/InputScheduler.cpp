@@ -0,0 +1,160 @@
+#include <Coro/InputScheduler.hpp>
+#include <Text/Utf.hpp>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+
+using namespace io;
+
+InputScheduler::KeyAwaiter::KeyAwaiter(InputScheduler& scheduler, const EventFilter& filter, uint64_t timeout_ns)
+    : scheduler(scheduler)
+    , filter(filter) {
+    if(timeout_ns)
+        deadline = monotonic_ns() + timeout_ns;
+}
+
+InputScheduler::KeyAwaiter::~KeyAwaiter() {
+    if(linked() && deadline)
+        --scheduler.timed_waiters;
+}
+
+void InputScheduler::KeyAwaiter::await_suspend(std::coroutine_handle<> h) {
+    handle = h;
+    if(deadline)
+        ++scheduler.timed_waiters;
+    scheduler.key_waiters.push_back(this);
+}
+
+void InputScheduler::TextLineAwaiter::await_suspend(std::coroutine_handle<> h) {
+    handle = h;
+    scheduler.text_waiters.push_back(this);
+}
+
+InputScheduler::InputScheduler(IWindowContext& ctx, int priority) : ctx(ctx) {
+    key_token = ctx.subscribe(EventType::key_input, [this](const InputEvent& e) { return on_key(e); }, priority);
+    character_token = ctx.subscribe(EventType::character, [this](const InputEvent& e) { return on_character(e); }, priority);
+    drain_id = ctx.add_drain_callback([this]() { on_drain(); });
+}
+
+InputScheduler::~InputScheduler() {
+    ctx.remove_drain_callback(drain_id);
+    ctx.unsubscribe(key_token);
+    ctx.unsubscribe(character_token);
+    // Destroying a frame unlinks the awaiters in it.
+    for(auto h : std::exchange(roots, {}))
+        h.destroy();
+}
+
+void InputScheduler::root_done(void* self, std::coroutine_handle<> h, std::exception_ptr e) {
+    auto& s = *static_cast<InputScheduler*>(self);
+    s.roots.erase(std::find(s.roots.begin(), s.roots.end(), h));
+    if(e && !s.failure)
+        s.failure = e;
+    h.destroy();
+}
+
+void InputScheduler::resume(std::coroutine_handle<> h) {
+    h.resume();
+    if(failure)
+        std::rethrow_exception(std::exchange(failure, nullptr));
+}
+
+void InputScheduler::resume_all(Link& ready) {
+    std::exception_ptr first;
+    while(ready.linked()) {
+        auto w = ready.next;
+        w->unlink();
+        if(auto k = static_cast<KeyAwaiter*>(w); k->deadline)
+            --timed_waiters;
+        // The rest of `ready` still resumes; the first exception is rethrown
+        // once it is empty.
+        try {
+            resume(static_cast<KeyAwaiter*>(w)->handle);
+        } catch(...) {
+            if(!first)
+                first = std::current_exception();
+        }
+    }
+    if(first)
+        std::rethrow_exception(first);
+}
+
+void InputScheduler::spawn(Task<> task) {
+    auto h = task.release();
+    h.promise().on_done = &InputScheduler::root_done;
+    h.promise().done_ctx = this;
+    roots.push_back(h);
+    resume(h);
+}
+
+InputScheduler::NextKeyAwaiter InputScheduler::next_key(const EventFilter& filter) {
+    return NextKeyAwaiter(*this, filter);
+}
+
+InputScheduler::AnyOfAwaiter InputScheduler::any_of(const EventFilter& filter, uint64_t timeout_ns) {
+    return AnyOfAwaiter(*this, filter, std::max<uint64_t>(timeout_ns, 1));
+}
+
+InputScheduler::TextLineAwaiter InputScheduler::text_line() {
+    return TextLineAwaiter(*this);
+}
+
+bool InputScheduler::on_key(const InputEvent& e) {
+    if(text_waiters.linked() && e.key.action != GLFW_RELEASE) {
+        auto t = static_cast<TextLineAwaiter*>(text_waiters.next);
+        switch(e.key.key) {
+        case GLFW_KEY_BACKSPACE:
+            while(!t->text.empty() && (t->text.back() & 0xc0) == 0x80)
+                t->text.pop_back();
+            if(!t->text.empty())
+                t->text.pop_back();
+            return true;
+        case GLFW_KEY_ESCAPE:
+            t->cancelled = true;
+            [[fallthrough]];
+        case GLFW_KEY_ENTER:
+        case GLFW_KEY_KP_ENTER:
+            t->unlink();
+            resume(t->handle);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    Link ready;
+    for(auto l = key_waiters.next; l != &key_waiters;) {
+        auto next = l->next;
+        auto w = static_cast<KeyAwaiter*>(l);
+        if(w->filter.matches(e)) {
+            w->result = e.key;
+            ready.push_back(w);
+        }
+        l = next;
+    }
+    if(!ready.linked())
+        return false;
+    resume_all(ready);
+    return true;
+}
+
+bool InputScheduler::on_character(const InputEvent& e) {
+    if(!text_waiters.linked())
+        return false;
+    append_utf8(static_cast<TextLineAwaiter*>(text_waiters.next)->text, &e.codepoint, 1);
+    return true;
+}
+
+void InputScheduler::on_drain() {
+    if(!timed_waiters)
+        return;
+    auto now = monotonic_ns();
+    Link ready;
+    for(auto l = key_waiters.next; l != &key_waiters;) {
+        auto next = l->next;
+        auto w = static_cast<KeyAwaiter*>(l);
+        if(w->deadline && w->deadline <= now)
+            ready.push_back(w);
+        l = next;
+    }
+    resume_all(ready);
+}
@@ -0,0 +1,123 @@
+#include <Text/TerminalTextRenderer.hpp>
+#include <Text/Utf.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace io;
+
+namespace {
+
+bool continuation(char c) {
+    return (static_cast<unsigned char>(c) & 0xc0) == 0x80;
+}
+
+// Encodes codepoints [pos, pos + count), which may straddle the cursor.
+void append_range(std::string& out, const TextEdit& te, size_t pos, size_t count) {
+    size_t gap = te.before_cursor_size();
+    size_t end = pos + count;
+    if(pos < gap)
+        append_utf8(out, te.before_cursor() + pos, std::min(end, gap) - pos);
+    if(end > gap) {
+        size_t from = std::max(pos, gap) - gap;
+        append_utf8(out, te.after_cursor() + from, end - gap - from);
+    }
+}
+
+void append_csi(std::string& out, size_t n, char command) {
+    out += "\x1b[";
+    out += std::to_string(n);
+    out += command;
+}
+
+}
+
+TerminalTextRenderer::TerminalTextRenderer(int fd)
+    : fd(fd) {}
+
+void TerminalTextRenderer::seek(size_t codepoint) {
+    while(utf8_gap_codepoint < codepoint) {
+        utf8.step_right();
+        while(utf8.after_size() && continuation(*utf8.after()))
+            utf8.step_right();
+        ++utf8_gap_codepoint;
+    }
+    while(utf8_gap_codepoint > codepoint) {
+        while(utf8.step_left() && continuation(*utf8.after()))
+            ;
+        --utf8_gap_codepoint;
+    }
+}
+
+void TerminalTextRenderer::replace(size_t pos, size_t removed, const TextEdit& te, size_t count) {
+    seek(pos);
+    for(size_t i = 0; i < removed; ++i) {
+        utf8.erase_after(1);
+        while(utf8.after_size() && continuation(*utf8.after()))
+            utf8.erase_after(1);
+    }
+    span.clear();
+    append_range(span, te, pos, count);
+    utf8.insert(span.data(), span.size());
+    utf8_gap_codepoint = pos + count;
+}
+
+void TerminalTextRenderer::flush() {
+    const char* p = frame.data();
+    size_t n = frame.size();
+    while(n) {
+        auto written = ::write(fd, p, n);
+        if(written < 0) {
+            if(errno == EINTR)
+                continue;
+            throw std::runtime_error("Couldn't write to terminal");
+        }
+        p += written;
+        n -= written;
+    }
+}
+
+bool TerminalTextRenderer::render(TextEdit& te) {
+    auto damage = te.take_damage();
+    frame.clear();
+    if(full_redraw) {
+        utf8.clear();
+        utf8_gap_codepoint = 0;
+        replace(0, 0, te, te.size());
+        length = te.size();
+        frame += '\r';
+        frame += span;
+        frame += "\x1b[K";
+        full_redraw = false;
+    } else {
+        if(!damage.text_changed() && !damage.cursor_moved)
+            return false;
+        if(damage.text_changed()) {
+            size_t size = te.size();
+            size_t prefix = std::min({damage.prefix, length, size});
+            size_t suffix = std::min({damage.suffix, length - prefix, size - prefix});
+            size_t removed = length - prefix - suffix;
+            size_t added = size - prefix - suffix;
+            if(removed || added) {
+                replace(prefix, removed, te, added);
+                append_csi(frame, prefix + 1, 'G');
+                if(added > removed)
+                    append_csi(frame, added - removed, '@');
+                else if(removed > added)
+                    append_csi(frame, removed - added, 'P');
+                frame += span;
+                length = size;
+            }
+        }
+    }
+    append_csi(frame, te.get_cursor() + 1, 'G');
+    flush();
+    return true;
+}
+
+std::string TerminalTextRenderer::utf8_text() const {
+    std::string s(utf8.before(), utf8.before_size());
+    s.append(utf8.after(), utf8.after_size());
+    return s;
+}
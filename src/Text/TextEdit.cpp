@@ -0,0 +1,106 @@
+#include <Text/TextEdit.hpp>
+#include <Text/Utf.hpp>
+
+using namespace io;
+
+TextEdit::CharClass TextEdit::classify(uint32_t c) {
+    switch(c) {
+    case ' ': case '\t': case '\n': case '\r': case '\v': case '\f':
+    case 0x00a0: case 0x1680: case 0x2028: case 0x2029: case 0x202f:
+    case 0x205f: case 0x3000:
+        return CharClass::space;
+    }
+    if(c >= 0x2000 && c <= 0x200a)
+        return CharClass::space;
+    if(c < 0x80 && !((c >= '0' && c <= '9') || (c >= 'A' && c <= 'Z')
+                     || (c >= 'a' && c <= 'z') || c == '_'))
+        return CharClass::punctuation;
+    return CharClass::word;
+}
+
+size_t TextEdit::line_start(size_t pos) const {
+    while(pos > 0 && text[pos - 1] != '\n')
+        --pos;
+    return pos;
+}
+
+size_t TextEdit::line_end(size_t pos) const {
+    while(pos < text.size() && text[pos] != '\n')
+        ++pos;
+    return pos;
+}
+
+void TextEdit::insert_utf8(const char* utf8, size_t size) {
+    if(!size)
+        return;
+    damaged(text.gap(), 0);
+    text.commit(utf8_to_utf32(utf8, size, text.prepare(size)));
+}
+
+bool TextEdit::set_cursor(size_t pos) {
+    pos = std::min(pos, text.size());
+    if(pos == text.gap())
+        return false;
+    text.move_gap(pos);
+    damage.cursor_moved = true;
+    return true;
+}
+
+bool TextEdit::move_word_left() {
+    size_t pos = text.gap();
+    while(pos > 0 && classify(text[pos - 1]) == CharClass::space)
+        --pos;
+    if(pos > 0) {
+        auto c = classify(text[pos - 1]);
+        while(pos > 0 && classify(text[pos - 1]) == c)
+            --pos;
+    }
+    return set_cursor(pos);
+}
+
+bool TextEdit::move_word_right() {
+    size_t pos = text.gap();
+    if(pos < text.size()) {
+        auto c = classify(text[pos]);
+        if(c != CharClass::space)
+            while(pos < text.size() && classify(text[pos]) == c)
+                ++pos;
+    }
+    while(pos < text.size() && classify(text[pos]) == CharClass::space)
+        ++pos;
+    return set_cursor(pos);
+}
+
+bool TextEdit::move_line_start() {
+    return set_cursor(line_start(text.gap()));
+}
+
+bool TextEdit::move_line_end() {
+    return set_cursor(line_end(text.gap()));
+}
+
+bool TextEdit::move_line_up() {
+    size_t start = line_start(text.gap());
+    if(start == 0)
+        return false;
+    size_t column = text.gap() - start;
+    size_t prev = line_start(start - 1);
+    return set_cursor(prev + std::min(column, start - 1 - prev));
+}
+
+bool TextEdit::move_line_down() {
+    size_t end = line_end(text.gap());
+    if(end == text.size())
+        return false;
+    size_t column = text.gap() - line_start(text.gap());
+    size_t next = end + 1;
+    return set_cursor(next + std::min(column, line_end(next) - next));
+}
+
+std::u32string TextEdit::str() const {
+    std::u32string s;
+    s.reserve(text.size());
+    s.append(text.before(), text.before() + text.before_size());
+    s.append(text.after(), text.after() + text.after_size());
+    return s;
+}
@@ -0,0 +1,334 @@
+#include <Text/Utf.hpp>
+#include <atomic>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IO_UTF_X86 1
+#endif
+
+using namespace io;
+
+namespace {
+
+constexpr uint32_t replacement = 0xfffd;
+
+size_t encode(uint32_t c, char* out) {
+    if(c < 0x80) {
+        out[0] = static_cast<char>(c);
+        return 1;
+    }
+    if(c < 0x800) {
+        out[0] = static_cast<char>(0xc0 | c >> 6);
+        out[1] = static_cast<char>(0x80 | (c & 0x3f));
+        return 2;
+    }
+    if(c > 0x10ffff || (c >= 0xd800 && c <= 0xdfff))
+        c = replacement;
+    if(c < 0x10000) {
+        out[0] = static_cast<char>(0xe0 | c >> 12);
+        out[1] = static_cast<char>(0x80 | (c >> 6 & 0x3f));
+        out[2] = static_cast<char>(0x80 | (c & 0x3f));
+        return 3;
+    }
+    out[0] = static_cast<char>(0xf0 | c >> 18);
+    out[1] = static_cast<char>(0x80 | (c >> 12 & 0x3f));
+    out[2] = static_cast<char>(0x80 | (c >> 6 & 0x3f));
+    out[3] = static_cast<char>(0x80 | (c & 0x3f));
+    return 4;
+}
+
+// Decodes the sequence at `in` (size > 0) and returns the bytes consumed. An
+// ill-formed sequence yields U+FFFD, consumes its maximal subpart and clears
+// `valid`.
+size_t decode(const unsigned char* in, size_t size, uint32_t& c, bool& valid) {
+    unsigned char b0 = in[0];
+    if(b0 < 0x80) {
+        c = b0;
+        return 1;
+    }
+    size_t len;
+    unsigned char lo = 0x80, hi = 0xbf;
+    if(b0 >= 0xc2 && b0 <= 0xdf) {
+        len = 2;
+        c = b0 & 0x1f;
+    } else if(b0 >= 0xe0 && b0 <= 0xef) {
+        len = 3;
+        c = b0 & 0x0f;
+        if(b0 == 0xe0)
+            lo = 0xa0;
+        else if(b0 == 0xed)
+            hi = 0x9f;
+    } else if(b0 >= 0xf0 && b0 <= 0xf4) {
+        len = 4;
+        c = b0 & 0x07;
+        if(b0 == 0xf0)
+            lo = 0x90;
+        else if(b0 == 0xf4)
+            hi = 0x8f;
+    } else {
+        c = replacement;
+        valid = false;
+        return 1;
+    }
+    for(size_t i = 1; i < len; ++i) {
+        if(i >= size || in[i] < lo || in[i] > hi) {
+            c = replacement;
+            valid = false;
+            return i;
+        }
+        c = c << 6 | (in[i] & 0x3f);
+        lo = 0x80;
+        hi = 0xbf;
+    }
+    return len;
+}
+
+// Scalar kernels, also used for the blocks and tails the vector paths skip.
+size_t to_utf8_scalar(const uint32_t* in, size_t count, char* out) {
+    char* o = out;
+    for(size_t i = 0; i < count; ++i)
+        o += encode(in[i], o);
+    return o - out;
+}
+
+// Decodes from `*p` until at least `stop`, returning the codepoints written.
+size_t to_utf32_until(const unsigned char*& p, const unsigned char* stop,
+                      const unsigned char* end, uint32_t* out, bool& valid) {
+    uint32_t* o = out;
+    while(p < stop)
+        p += decode(p, end - p, *o++, valid);
+    return o - out;
+}
+
+size_t to_utf32_scalar(const char* in, size_t size, uint32_t* out) {
+    auto p = reinterpret_cast<const unsigned char*>(in);
+    bool valid = true;
+    return to_utf32_until(p, p + size, p + size, out, valid);
+}
+
+bool validate_until(const unsigned char*& p, const unsigned char* stop, const unsigned char* end) {
+    bool valid = true;
+    uint32_t c;
+    while(p < stop && valid)
+        p += decode(p, end - p, c, valid);
+    return valid;
+}
+
+bool validate_scalar(const char* in, size_t size) {
+    auto p = reinterpret_cast<const unsigned char*>(in);
+    return validate_until(p, p + size, p + size);
+}
+
+#ifdef IO_UTF_X86
+
+// Blocks that are entirely ASCII are converted with packs/unpacks; any other
+// block goes through the scalar kernel.
+
+__attribute__((target("sse2")))
+size_t to_utf8_sse2(const uint32_t* in, size_t count, char* out) {
+    const __m128i high = _mm_set1_epi32(~0x7f);
+    const __m128i zero = _mm_setzero_si128();
+    char* o = out;
+    size_t i = 0;
+    for(; i + 16 <= count; i += 16) {
+        auto p = reinterpret_cast<const __m128i*>(in + i);
+        __m128i a = _mm_loadu_si128(p), b = _mm_loadu_si128(p + 1);
+        __m128i c = _mm_loadu_si128(p + 2), d = _mm_loadu_si128(p + 3);
+        __m128i any = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if(_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, high), zero)) != 0xffff) {
+            o += to_utf8_scalar(in + i, 16, o);
+            continue;
+        }
+        __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(a, b), _mm_packs_epi32(c, d));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(o), bytes);
+        o += 16;
+    }
+    return (o - out) + to_utf8_scalar(in + i, count - i, o);
+}
+
+__attribute__((target("avx2")))
+size_t to_utf8_avx2(const uint32_t* in, size_t count, char* out) {
+    const __m256i high = _mm256_set1_epi32(~0x7f);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    char* o = out;
+    size_t i = 0;
+    for(; i + 32 <= count; i += 32) {
+        auto p = reinterpret_cast<const __m256i*>(in + i);
+        __m256i a = _mm256_loadu_si256(p), b = _mm256_loadu_si256(p + 1);
+        __m256i c = _mm256_loadu_si256(p + 2), d = _mm256_loadu_si256(p + 3);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if(!_mm256_testz_si256(any, high)) {
+            o += to_utf8_scalar(in + i, 32, o);
+            continue;
+        }
+        // Packing works within 128-bit lanes; put the 4-byte groups back in order.
+        __m256i bytes = _mm256_packus_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+        bytes = _mm256_permutevar8x32_epi32(bytes, order);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(o), bytes);
+        o += 32;
+    }
+    return (o - out) + to_utf8_sse2(in + i, count - i, o);
+}
+
+__attribute__((target("sse2")))
+size_t to_utf32_sse2(const char* in, size_t size, uint32_t* out) {
+    const __m128i zero = _mm_setzero_si128();
+    auto p = reinterpret_cast<const unsigned char*>(in);
+    auto end = p + size;
+    uint32_t* o = out;
+    bool valid = true;
+    while(end - p >= 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        if(_mm_movemask_epi8(v)) {
+            o += to_utf32_until(p, p + 16, end, o, valid);
+            continue;
+        }
+        __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+        auto q = reinterpret_cast<__m128i*>(o);
+        _mm_storeu_si128(q, _mm_unpacklo_epi16(lo, zero));
+        _mm_storeu_si128(q + 1, _mm_unpackhi_epi16(lo, zero));
+        _mm_storeu_si128(q + 2, _mm_unpacklo_epi16(hi, zero));
+        _mm_storeu_si128(q + 3, _mm_unpackhi_epi16(hi, zero));
+        p += 16;
+        o += 16;
+    }
+    return (o - out) + to_utf32_until(p, end, end, o, valid);
+}
+
+__attribute__((target("avx2")))
+size_t to_utf32_avx2(const char* in, size_t size, uint32_t* out) {
+    auto p = reinterpret_cast<const unsigned char*>(in);
+    auto end = p + size;
+    uint32_t* o = out;
+    bool valid = true;
+    while(end - p >= 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        if(_mm256_movemask_epi8(v)) {
+            o += to_utf32_until(p, p + 32, end, o, valid);
+            continue;
+        }
+        auto q = reinterpret_cast<__m256i*>(o);
+        for(int k = 0; k < 4; ++k) {
+            __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(p + 8 * k));
+            _mm256_storeu_si256(q + k, _mm256_cvtepu8_epi32(bytes));
+        }
+        p += 32;
+        o += 32;
+    }
+    return (o - out) + to_utf32_sse2(reinterpret_cast<const char*>(p), end - p, o);
+}
+
+__attribute__((target("sse2")))
+bool validate_sse2(const char* in, size_t size) {
+    auto p = reinterpret_cast<const unsigned char*>(in);
+    auto end = p + size;
+    while(end - p >= 16) {
+        if(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))) {
+            if(!validate_until(p, p + 16, end))
+                return false;
+            continue;
+        }
+        p += 16;
+    }
+    return validate_until(p, end, end);
+}
+
+__attribute__((target("avx2")))
+bool validate_avx2(const char* in, size_t size) {
+    auto p = reinterpret_cast<const unsigned char*>(in);
+    auto end = p + size;
+    while(end - p >= 32) {
+        if(_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)))) {
+            if(!validate_until(p, p + 32, end))
+                return false;
+            continue;
+        }
+        p += 32;
+    }
+    return validate_sse2(reinterpret_cast<const char*>(p), end - p);
+}
+
+#endif
+
+bool supported(UtfPath path) {
+    switch(path) {
+#ifdef IO_UTF_X86
+    case UtfPath::avx2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+    case UtfPath::sse2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+    case UtfPath::scalar:
+        return true;
+    default:
+        return false;
+    }
+}
+
+UtfPath detect() {
+    for(auto path : {UtfPath::avx2, UtfPath::sse2})
+        if(supported(path))
+            return path;
+    return UtfPath::scalar;
+}
+
+std::atomic<UtfPath>& current_path() {
+    static std::atomic<UtfPath> path{detect()};
+    return path;
+}
+
+}
+
+UtfPath io::get_utf_path() {
+    return current_path().load(std::memory_order_relaxed);
+}
+
+void io::set_utf_path(UtfPath path) {
+    current_path().store(supported(path) ? path : UtfPath::scalar, std::memory_order_relaxed);
+}
+
+size_t io::utf32_to_utf8(const uint32_t* in, size_t count, char* out) {
+    switch(get_utf_path()) {
+#ifdef IO_UTF_X86
+    case UtfPath::avx2:
+        return to_utf8_avx2(in, count, out);
+    case UtfPath::sse2:
+        return to_utf8_sse2(in, count, out);
+#endif
+    default:
+        return to_utf8_scalar(in, count, out);
+    }
+}
+
+void io::append_utf8(std::string& out, const uint32_t* in, size_t count) {
+    size_t size = out.size();
+    out.resize(size + max_utf8_size(count));
+    out.resize(size + utf32_to_utf8(in, count, out.data() + size));
+}
+
+size_t io::utf8_to_utf32(const char* in, size_t size, uint32_t* out) {
+    switch(get_utf_path()) {
+#ifdef IO_UTF_X86
+    case UtfPath::avx2:
+        return to_utf32_avx2(in, size, out);
+    case UtfPath::sse2:
+        return to_utf32_sse2(in, size, out);
+#endif
+    default:
+        return to_utf32_scalar(in, size, out);
+    }
+}
+
+bool io::validate_utf8(const char* in, size_t size) {
+    switch(get_utf_path()) {
+#ifdef IO_UTF_X86
+    case UtfPath::avx2:
+        return validate_avx2(in, size);
+    case UtfPath::sse2:
+        return validate_sse2(in, size);
+#endif
+    default:
+        return validate_scalar(in, size);
+    }
+}
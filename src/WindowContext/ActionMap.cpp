@@ -0,0 +1,141 @@
+#include <WindowContext/ActionMap.hpp>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace io;
+
+ActionMap::ActionMap() {
+    rebuild();
+}
+
+void ActionMap::rebuild() {
+    auto t = std::make_unique<Table>();
+    t->source = bindings;
+
+    std::vector<std::pair<size_t, Binding>> slots;
+    for(auto& b : bindings) {
+        Binding c{b.mods, b.mods_mask, b.action, {-1, -1, -1}};
+        for(size_t i = 0; i < c.chord.size(); ++i)
+            c.chord[i] = static_cast<int16_t>(b.chord[i]);
+        for(size_t a = 0; a < action_kinds; ++a)
+            if(b.actions & (1 << a))
+                slots.push_back({b.input * action_kinds + a, c});
+    }
+    std::stable_sort(slots.begin(), slots.end(),
+                     [](const auto& l, const auto& r) { return l.first < r.first; });
+
+    t->bindings.reserve(slots.size());
+    size_t slot = 0;
+    for(auto& [s, b] : slots) {
+        while(slot <= s)
+            t->first[slot++] = static_cast<uint16_t>(t->bindings.size());
+        t->bindings.push_back(b);
+    }
+    while(slot < t->first.size())
+        t->first[slot++] = static_cast<uint16_t>(t->bindings.size());
+
+    table.store(reclaimer, std::move(t));
+    version.fetch_add(1, std::memory_order_release);
+}
+
+void ActionMap::refresh(uint64_t v) {
+    auto guard = reclaimer.pin();
+    auto t = table.load();
+    cached.first = t->first;
+    cached.bindings = t->bindings;
+    cached_version = v;
+}
+
+void ActionMap::bind(const ActionBinding& binding) {
+    if(binding.input < 0 || static_cast<size_t>(binding.input) >= input_count)
+        throw std::out_of_range("ActionMap: input out of range");
+    if(binding.action >= ActionStates::max_actions)
+        throw std::out_of_range("ActionMap: action id out of range");
+    for(auto c : binding.chord)
+        if(c != ActionBinding::no_input && (c < 0 || static_cast<size_t>(c) >= input_count))
+            throw std::out_of_range("ActionMap: chord input out of range");
+    if(binding.mods & ~binding.mods_mask)
+        throw std::invalid_argument("ActionMap: mods outside mods_mask");
+
+    std::lock_guard lk(mutex);
+    if((bindings.size() + 1) * action_kinds > UINT16_MAX)
+        throw std::length_error("ActionMap: too many bindings");
+    bindings.push_back(binding);
+    rebuild();
+}
+
+void ActionMap::bind(int input, uint8_t actions, ActionId action, uint8_t mods, uint8_t mods_mask) {
+    ActionBinding b;
+    b.input = input;
+    b.actions = actions;
+    b.mods = mods;
+    b.mods_mask = mods_mask;
+    b.action = action;
+    bind(b);
+}
+
+void ActionMap::unbind(ActionId action) {
+    std::lock_guard lk(mutex);
+    bindings.erase(std::remove_if(bindings.begin(), bindings.end(),
+                                  [action](const ActionBinding& b) { return b.action == action; }),
+                   bindings.end());
+    rebuild();
+}
+
+void ActionMap::clear() {
+    std::lock_guard lk(mutex);
+    bindings.clear();
+    rebuild();
+}
+
+bool ActionMap::chord_held(const Binding& b, const std::bitset<input_count>& held) {
+    for(auto c : b.chord)
+        if(c >= 0 && !held.test(c))
+            return false;
+    return true;
+}
+
+const ActionMap::Binding* ActionMap::find(int input, int action, size_t& count) const {
+    auto slot = input * action_kinds + action;
+    count = cached.first[slot + 1] - cached.first[slot];
+    return cached.bindings.data() + cached.first[slot];
+}
+
+void ActionMap::evaluate(const InputState& state, ActionStates& out) {
+    out.active.reset();
+    out.triggered.reset();
+    out.released.reset();
+
+    auto is_button = [](int input) {
+        return static_cast<size_t>(input) >= InputState::key_count;
+    };
+    auto down = [&](int input) {
+        return is_button(input) ? state.button_down(input - InputState::key_count)
+                                : state.key_down(input);
+    };
+    auto pressed = [&](int input) {
+        return is_button(input) ? state.button_pressed(input - InputState::key_count)
+                                : state.key_pressed(input);
+    };
+    auto released = [&](int input) {
+        return is_button(input) ? state.button_released(input - InputState::key_count)
+                                : state.key_released(input);
+    };
+
+    auto guard = reclaimer.pin();
+    for(auto& b : table.load()->source) {
+        if((state.mods & b.mods_mask) != (b.mods & b.mods_mask))
+            continue;
+        bool chord = std::all_of(b.chord.begin(), b.chord.end(), [&down](int c) {
+            return c == ActionBinding::no_input || down(c);
+        });
+        if(!chord)
+            continue;
+        if(down(b.input))
+            out.active.set(b.action);
+        if(pressed(b.input))
+            out.triggered.set(b.action);
+        if(released(b.input))
+            out.released.set(b.action);
+    }
+}
@@ -0,0 +1,41 @@
+#include <WindowContext/EpochReclaimer.hpp>
+#include <algorithm>
+
+using namespace io;
+
+bool EpochReclaimer::try_advance() {
+    auto e = epoch.load(std::memory_order_seq_cst);
+    if(readers[(e - 1) & 1].v.load(std::memory_order_seq_cst) != 0)
+        return false;
+    return epoch.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+}
+
+void EpochReclaimer::free_safe() {
+    auto e = epoch.load(std::memory_order_seq_cst);
+    auto it = std::partition(retired.begin(), retired.end(),
+                             [e](const Retired& r) { return r.epoch + 2 > e; });
+    std::for_each(it, retired.end(), [](const Retired& r) { r.deleter(r.ptr); });
+    retired.erase(it, retired.end());
+}
+
+void EpochReclaimer::retire(void* ptr, void (*deleter)(void*)) {
+    std::lock_guard lk(retired_mutex);
+    retired.push_back({epoch.load(std::memory_order_seq_cst), ptr, deleter});
+    if(try_advance())
+        try_advance();
+    free_safe();
+}
+
+void EpochReclaimer::collect() {
+    std::unique_lock lk(retired_mutex, std::try_to_lock);
+    if(!lk || retired.empty())
+        return;
+    if(try_advance())
+        try_advance();
+    free_safe();
+}
+
+EpochReclaimer::~EpochReclaimer() {
+    for(auto& r : retired)
+        r.deleter(r.ptr);
+}
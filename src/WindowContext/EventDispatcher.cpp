@@ -0,0 +1,385 @@
+#include <WindowContext/EventDispatcher.hpp>
+#include <algorithm>
+
+using namespace io;
+
+EventDispatcher::EventDispatcher(size_t queue_capacity)
+    : queue(queue_capacity) {}
+
+EventDispatcher::~EventDispatcher() {
+    for(auto& [id, l] : executor_listeners)
+        l.queue->close();
+}
+
+void EventDispatcher::apply_prediction() {
+    std::lock_guard lock(prediction_mutex);
+    applied_prediction = prediction_version.load(std::memory_order_relaxed);
+    state.set_prediction(prediction, prediction_config);
+}
+
+void EventDispatcher::track(const InputEvent& e) {
+    if(prediction_version.load(std::memory_order_relaxed) != applied_prediction)
+        apply_prediction();
+    switch(e.type) {
+    case EventType::key_input:
+        state.key(e.key.key, e.key.action, e.key.mods, e.timestamp);
+        break;
+    case EventType::cursor_position:
+        state.cursor(e.position.x, e.position.y, e.timestamp);
+        break;
+    case EventType::mouse_movement:
+        state.motion(e.position.x, e.position.y, e.timestamp);
+        break;
+    case EventType::mouse_input:
+        state.button(e.button.button, e.button.action, e.button.mods, e.timestamp);
+        break;
+    case EventType::scroll_input:
+        state.scroll(e.position.x, e.position.y, e.timestamp);
+        break;
+    case EventType::gamepad_connection:
+        state.gamepad_connection(e.gamepad.pad, e.gamepad.action, e.timestamp);
+        break;
+    case EventType::gamepad_button:
+        state.gamepad_button(e.gamepad.pad, e.gamepad.code, e.gamepad.action, e.timestamp);
+        break;
+    case EventType::gamepad_axis:
+        state.gamepad_axis(e.gamepad.pad, e.gamepad.code, e.gamepad.value, e.timestamp);
+        break;
+    default:
+        break;
+    }
+}
+
+void EventDispatcher::update_interest() {
+    constexpr uint32_t state_types = event_bit(EventType::key_input) | event_bit(EventType::cursor_position)
+        | event_bit(EventType::mouse_movement) | event_bit(EventType::mouse_input)
+        | event_bit(EventType::scroll_input) | event_bit(EventType::gamepad_connection)
+        | event_bit(EventType::gamepad_button) | event_bit(EventType::gamepad_axis);
+
+    {
+        std::lock_guard lock(interest_mutex);
+        EventAdmission::Builder b;
+        // Null checks only; nothing is dereferenced, so no pin is needed.
+        if(input_event_callback.load() || recorder.load())
+            b.add_all();
+        handlers.add_interest(b);
+        inline_handlers.add_interest(b);
+        admission.publish(b);
+        interest_types = b.types | (track_state ? state_types : 0);
+        ++interest_generation;
+    }
+    notify_interest();
+}
+
+// GLFW's callback pauses the pump thread, whose inline handlers may be
+// subscribing at that moment, so it must not be called under the lock.
+void EventDispatcher::notify_interest() {
+    std::unique_lock lock(interest_mutex);
+    if(notifying)
+        return;
+    notifying = true;
+    while(interest_callback && notified_generation != interest_generation) {
+        notified_generation = interest_generation;
+        auto cb = interest_callback;
+        auto types = interest_types;
+        lock.unlock();
+        try {
+            cb(types);
+        } catch(...) {
+            lock.lock();
+            notifying = false;
+            interest_idle.notify_all();
+            throw;
+        }
+        lock.lock();
+    }
+    notifying = false;
+    interest_idle.notify_all();
+}
+
+void EventDispatcher::set_interest_callback(InterestCallback cb) {
+    {
+        std::unique_lock lock(interest_mutex);
+        interest_idle.wait(lock, [this] { return !notifying; });
+        interest_callback = std::move(cb);
+    }
+    update_interest();
+}
+
+void EventDispatcher::set_state_tracking(bool val) {
+    track_state = val;
+    update_interest();
+}
+
+void EventDispatcher::set_motion_prediction(bool val, const PredictionConfig& config) {
+    MotionPredictor::validate(config);
+    std::lock_guard lock(prediction_mutex);
+    prediction = val;
+    prediction_config = config;
+    prediction_version.fetch_add(1, std::memory_order_relaxed);
+}
+
+void EventDispatcher::set_slot(EventType type, EventHandler handler) {
+    handlers.set_slot(reclaimer, type, std::move(handler));
+    update_interest();
+}
+
+void EventDispatcher::set_slot(EventType type, SlotCallback callback) {
+    handlers.set_slot(reclaimer, type, std::move(callback));
+    update_interest();
+}
+
+bool EventDispatcher::dispatch_inline(const InputEvent& e) {
+    auto guard = reclaimer.pin();
+    return inline_handlers.dispatch(e);
+}
+
+void EventDispatcher::flush_characters() {
+    if(characters.empty())
+        return;
+    hand_over_characters(characters.data(), characters.size());
+    characters.clear();
+}
+
+void EventDispatcher::hand_over_characters(const uint32_t* codepoints, size_t count) {
+    if(auto cb = characters_callback.load())
+        (*cb)(codepoints, count);
+    else if(auto cb = character_callback.load())
+        for(size_t i = 0; i < count; ++i)
+            (*cb)(codepoints[i]);
+}
+
+void EventDispatcher::deliver(const InputEvent& e) {
+    if(e.type != EventType::character)
+        flush_characters();
+    // consume_all() takes each event off the queue right after the previous
+    // one's handlers return, so that clock read is also this event's dequeue
+    // time; coalesced motion starts at the flush.
+    auto start = dispatch_time;
+    if(auto cb = input_event_callback.load())
+        (*cb)(e);
+    handlers.dispatch(e);
+    dispatch_time = monotonic_ns();
+    consumed[static_cast<size_t>(e.type)].delivered.add();
+    latency.record(e.type, start > e.timestamp ? start - e.timestamp : 0, dispatch_time - start);
+}
+
+size_t EventDispatcher::drain() {
+    size_t n;
+    {
+        auto guard = reclaimer.pin();
+        state.acquire();
+        auto rec = recorder.load();
+        auto handle = [this, rec](const InputEvent& e) {
+            if(rec) {
+                rec->record(e);
+                // The write counts as queued time, not the listeners'.
+                dispatch_time = monotonic_ns();
+            }
+            if(coalesce_motion.load(std::memory_order_relaxed))
+                coalescer.push(e, [this](const InputEvent& c) { deliver(c); });
+            else
+                deliver(e);
+        };
+        dispatch_time = monotonic_ns();
+        n = queue.consume_all(handle);
+        coalescer.flush([this](const InputEvent& c) { deliver(c); });
+        flush_characters();
+        if(auto hooks = drain_hooks.load())
+            for(auto& h : *hooks)
+                h.callback();
+        if(auto cb = drain_callback.load())
+            (*cb)();
+    }
+    reclaimer.collect();
+    if(stats_sink && dispatch_time >= next_stats) {
+        next_stats = dispatch_time + stats_period;
+        stats_sink(stats());
+    }
+    return n;
+}
+
+void EventDispatcher::deliver_characters(const uint32_t* codepoints, size_t count) {
+    auto guard = reclaimer.pin();
+    flush_characters();
+    if(auto rec = recorder.load()) {
+        auto now = monotonic_ns();
+        for(size_t i = 0; i < count; ++i) {
+            auto e = InputEvent::make_character(codepoints[i]);
+            e.timestamp = now;
+            rec->record(e);
+        }
+    }
+    hand_over_characters(codepoints, count);
+}
+
+SubscriptionToken EventDispatcher::subscribe(EventType type, EventHandler handler, int priority,
+                                             ListenerAffinity affinity, const EventFilter& filter) {
+    auto token = subscribe_to(type, std::move(handler), priority, affinity, filter);
+    update_interest();
+    return token;
+}
+
+SubscriptionToken EventDispatcher::subscribe_to(EventType type, EventHandler handler, int priority,
+                                                ListenerAffinity affinity, const EventFilter& filter) {
+    switch(affinity) {
+    case ListenerAffinity::inline_: {
+        auto token = inline_handlers.subscribe(reclaimer, type, std::move(handler), priority, filter);
+        ++inline_count;
+        return token;
+    }
+    case ListenerAffinity::executor: {
+        std::lock_guard lock(executor_mutex);
+        if(!executor)
+            executor = Executor::acquire();
+        auto q = std::make_shared<SerialQueue>(*executor, std::move(handler));
+        auto token = handlers.subscribe(reclaimer, type, [q](const InputEvent& e) {
+            q->post(e);
+            return false;
+        }, priority, filter, q->get_counters());
+        executor_listeners.emplace(token.id, ExecutorListener{token, std::move(q)});
+        return token;
+    }
+    default:
+        return handlers.subscribe(reclaimer, type, std::move(handler), priority, filter);
+    }
+}
+
+bool EventDispatcher::unsubscribe(SubscriptionToken token) {
+    if(token.id & inline_id_bit) {
+        if(!inline_handlers.unsubscribe(reclaimer, token))
+            return false;
+        --inline_count;
+        update_interest();
+        return true;
+    }
+    if(!handlers.unsubscribe(reclaimer, token))
+        return false;
+    update_interest();
+    std::shared_ptr<SerialQueue> q;
+    {
+        std::lock_guard lock(executor_mutex);
+        auto it = executor_listeners.find(token.id);
+        if(it == executor_listeners.end())
+            return true;
+        q = std::move(it->second.queue);
+        executor_listeners.erase(it);
+    }
+    // A drain still walking the old list posts into the closed queue, which
+    // drops the event.
+    q->close();
+    return true;
+}
+
+std::vector<ListenerQueueStats> EventDispatcher::get_listener_queue_stats() {
+    std::lock_guard lock(executor_mutex);
+    std::vector<ListenerQueueStats> stats;
+    stats.reserve(executor_listeners.size());
+    for(auto& [id, l] : executor_listeners)
+        stats.push_back(l.queue->stats(l.token));
+    return stats;
+}
+
+void EventDispatcher::set_input_event_callback(InputEventCallback cb) {
+    input_event_callback.store(reclaimer, cb ? std::make_unique<InputEventCallback>(std::move(cb))
+                                             : nullptr);
+    update_interest();
+}
+
+void EventDispatcher::set_drain_callback(DrainCallback cb) {
+    drain_callback.store(reclaimer, cb ? std::make_unique<DrainCallback>(std::move(cb)) : nullptr);
+}
+
+uint64_t EventDispatcher::add_drain_callback(DrainCallback cb) {
+    if(!cb)
+        throw std::invalid_argument("Drain callback is empty");
+    std::lock_guard lock(drain_hooks_mutex);
+    auto hooks = std::make_unique<std::vector<DrainHook>>();
+    if(auto old = drain_hooks.load())
+        *hooks = *old;
+    auto id = next_drain_hook++;
+    hooks->push_back({id, std::move(cb)});
+    drain_hooks.store(reclaimer, std::move(hooks));
+    return id;
+}
+
+bool EventDispatcher::remove_drain_callback(uint64_t id) {
+    std::lock_guard lock(drain_hooks_mutex);
+    auto old = drain_hooks.load();
+    if(!old)
+        return false;
+    auto it = std::find_if(old->begin(), old->end(), [id](const DrainHook& h) { return h.id == id; });
+    if(it == old->end())
+        return false;
+    std::unique_ptr<std::vector<DrainHook>> hooks;
+    if(old->size() > 1) {
+        hooks = std::make_unique<std::vector<DrainHook>>();
+        for(auto& h : *old)
+            if(h.id != id)
+                hooks->push_back(h);
+    }
+    drain_hooks.store(reclaimer, std::move(hooks));
+    return true;
+}
+
+void EventDispatcher::set_characters_slot(CharactersInputCallback cb) {
+    if(!cb) {
+        set_slot(EventType::character, EventHandler());
+        characters_callback.store(reclaimer, nullptr);
+        character_callback.store(reclaimer, nullptr);
+        return;
+    }
+    characters_callback.store(reclaimer, std::make_unique<CharactersInputCallback>(std::move(cb)));
+    character_callback.store(reclaimer, nullptr);
+    collect_characters();
+}
+
+void EventDispatcher::set_characters_slot(CharacterInputCallback cb) {
+    if(!cb) {
+        set_characters_slot(CharactersInputCallback());
+        return;
+    }
+    // Stored first: the span callback wins while both are set.
+    character_callback.store(reclaimer, std::make_unique<CharacterInputCallback>(std::move(cb)));
+    characters_callback.store(reclaimer, nullptr);
+    collect_characters();
+}
+
+void EventDispatcher::collect_characters() {
+    set_slot(EventType::character, [this](const InputEvent& e) {
+        characters.push_back(e.codepoint);
+        return false;
+    });
+}
+
+void EventDispatcher::start_recording(const std::string& path) {
+    recorder.store(reclaimer, std::make_unique<EventRecorder>(path));
+    update_interest();
+}
+
+void EventDispatcher::stop_recording() {
+    recorder.store(reclaimer, nullptr);
+    update_interest();
+}
+
+InputStats EventDispatcher::stats() {
+    InputStats s;
+    s.timestamp = monotonic_ns();
+    for(size_t t = 0; t < event_type_count; ++t) {
+        auto& p = produced[t];
+        s.types[t] = {p.received.get(), p.filtered.get(), p.unfocused.get(), consumed[t].delivered.get()};
+    }
+    s.queue = queue.stats();
+    s.wakeups = wakeups.count();
+    s.wakeups_per_second = wakeups.rate(s.timestamp);
+    handlers.add_listener_stats(s.listeners, ListenerAffinity::main_thread, ListenerAffinity::executor);
+    inline_handlers.add_listener_stats(s.listeners, ListenerAffinity::inline_, ListenerAffinity::inline_);
+    s.listener_queues = get_listener_queue_stats();
+    return s;
+}
+
+void EventDispatcher::set_stats_sink(StatsSink sink, uint64_t period_ns) {
+    stats_sink = std::move(sink);
+    stats_period = period_ns;
+    next_stats = 0;
+}
@@ -0,0 +1,36 @@
+#include <WindowContext/EventFilter.hpp>
+#include <algorithm>
+
+using namespace io;
+
+void EventAdmission::Builder::add(EventType type, const EventFilter* filter) {
+    auto bit = event_bit(type);
+    types |= bit;
+    bool coded = type == EventType::key_input || type == EventType::mouse_input;
+    if(!coded || !filter) {
+        unfiltered |= bit;
+        return;
+    }
+    int base = type == EventType::key_input ? 0 : static_cast<int>(InputState::key_count);
+    int count = static_cast<int>(type == EventType::key_input ? InputState::key_count
+                                                              : InputState::button_count);
+    // Codes outside the table (GLFW_KEY_UNKNOWN) only reach unfiltered handlers.
+    int first = std::max(filter->first, 0);
+    int last = std::min(filter->last, count - 1);
+    for(int c = first; c <= last; ++c)
+        codes.set(base + c);
+    (type == EventType::key_input ? key_actions : button_actions) |= filter->actions;
+}
+
+void EventAdmission::publish(const Builder& b) {
+    for(size_t w = 0; w < word_count; ++w) {
+        uint64_t word = 0;
+        for(size_t i = 0; i < 64 && w * 64 + i < code_count; ++i)
+            word |= uint64_t(b.codes[w * 64 + i]) << i;
+        codes[w].store(word, std::memory_order_relaxed);
+    }
+    key_actions.store(b.key_actions, std::memory_order_relaxed);
+    button_actions.store(b.button_actions, std::memory_order_relaxed);
+    unfiltered.store(b.unfiltered, std::memory_order_relaxed);
+    types.store(b.types, std::memory_order_relaxed);
+}
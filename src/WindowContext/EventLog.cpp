@@ -0,0 +1,244 @@
+#include <WindowContext/EventLog.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace io;
+
+namespace {
+
+struct Header {
+    char magic[8];
+    uint16_t version;
+    uint16_t header_size;
+    uint16_t byte_order;
+    uint16_t reserved0;
+    uint64_t start_timestamp;
+    uint64_t reserved1;
+};
+static_assert(sizeof(Header) == EventLogFormat::header_size);
+
+size_t payload_size(EventType type) {
+    switch(type) {
+    case EventType::key_input:
+    case EventType::mouse_input:
+    case EventType::character:
+        return 4;
+    case EventType::window_resize:
+    case EventType::gamepad_connection:
+    case EventType::gamepad_button:
+    case EventType::gamepad_axis:
+        return 8;
+    case EventType::cursor_position:
+    case EventType::mouse_movement:
+    case EventType::scroll_input:
+        return 16;
+    default:
+        return 0;
+    }
+}
+
+template<typename T>
+void put(unsigned char*& p, T v) {
+    std::memcpy(p, &v, sizeof(T));
+    p += sizeof(T);
+}
+
+template<typename T>
+T get(const unsigned char*& p) {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+    return v;
+}
+
+}
+
+EventRecorder::EventRecorder(const std::string& path) {
+    file = std::fopen(path.c_str(), "wb");
+    if(!file)
+        throw std::runtime_error("Couldn't open event log " + path);
+    std::setvbuf(file, buffer, _IOFBF, sizeof(buffer));
+}
+
+EventRecorder::~EventRecorder() {
+    if(!header_written)
+        write_header(0);
+    std::fclose(file);
+}
+
+void EventRecorder::write_header(uint64_t start) {
+    Header h{};
+    std::memcpy(h.magic, EventLogFormat::magic, sizeof(h.magic));
+    h.version = EventLogFormat::version;
+    h.header_size = EventLogFormat::header_size;
+    h.byte_order = EventLogFormat::byte_order;
+    h.start_timestamp = start;
+    std::fwrite(&h, sizeof(h), 1, file);
+    header_written = true;
+    last_timestamp = start;
+}
+
+void EventRecorder::record(const InputEvent& e) {
+    if(!header_written)
+        write_header(e.timestamp);
+
+    unsigned char rec[1 + 10 + 16];
+    unsigned char* p = rec;
+    put<uint8_t>(p, static_cast<uint8_t>(e.type));
+    uint64_t delta = e.timestamp > last_timestamp ? e.timestamp - last_timestamp : 0;
+    last_timestamp += delta;
+    do {
+        uint8_t byte = delta & 0x7f;
+        delta >>= 7;
+        put<uint8_t>(p, delta ? byte | 0x80 : byte);
+    } while(delta);
+
+    switch(e.type) {
+    case EventType::key_input:
+        put<int16_t>(p, e.key.key);
+        put<uint8_t>(p, e.key.action);
+        put<uint8_t>(p, e.key.mods);
+        break;
+    case EventType::mouse_input:
+        put<int16_t>(p, e.button.button);
+        put<uint8_t>(p, e.button.action);
+        put<uint8_t>(p, e.button.mods);
+        break;
+    case EventType::character:
+        put<uint32_t>(p, e.codepoint);
+        break;
+    case EventType::window_resize:
+        put<int32_t>(p, e.size.width);
+        put<int32_t>(p, e.size.height);
+        break;
+    case EventType::cursor_position:
+    case EventType::mouse_movement:
+    case EventType::scroll_input:
+        put<double>(p, e.position.x);
+        put<double>(p, e.position.y);
+        break;
+    case EventType::gamepad_connection:
+    case EventType::gamepad_button:
+    case EventType::gamepad_axis:
+        put<uint8_t>(p, e.gamepad.pad);
+        put<uint8_t>(p, e.gamepad.code);
+        put<uint8_t>(p, e.gamepad.action);
+        put<uint8_t>(p, 0);
+        put<float>(p, e.gamepad.value);
+        break;
+    default:
+        return;
+    }
+    std::fwrite(rec, p - rec, 1, file);
+    ++records;
+}
+
+void EventRecorder::flush() {
+    std::fflush(file);
+}
+
+EventLogReader::EventLogReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0)
+        throw std::runtime_error("Couldn't open event log " + path);
+    struct stat st;
+    if(::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        ::close(fd);
+        throw std::runtime_error("Event log too short: " + path);
+    }
+    size = st.st_size;
+    void* m = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if(m == MAP_FAILED)
+        throw std::runtime_error("Couldn't map event log " + path);
+    data = static_cast<const unsigned char*>(m);
+    ::madvise(m, size, MADV_SEQUENTIAL);
+
+    Header h;
+    std::memcpy(&h, data, sizeof(h));
+    if(std::memcmp(h.magic, EventLogFormat::magic, sizeof(h.magic)) != 0
+            || h.byte_order != EventLogFormat::byte_order
+            || h.version > EventLogFormat::version
+            || h.header_size < sizeof(Header) || h.header_size > size) {
+        ::munmap(m, size);
+        throw std::runtime_error("Unsupported event log " + path);
+    }
+    offset = h.header_size;
+    start_timestamp = last_timestamp = h.start_timestamp;
+}
+
+EventLogReader::~EventLogReader() {
+    ::munmap(const_cast<unsigned char*>(data), size);
+}
+
+bool EventLogReader::next(InputEvent& e) {
+    const unsigned char* p = data + offset;
+    const unsigned char* end = data + size;
+    if(p == end)
+        return false;
+
+    auto type = static_cast<EventType>(*p++);
+    if(static_cast<size_t>(type) >= event_type_count)
+        throw std::runtime_error("Corrupt event log record");
+
+    uint64_t delta = 0;
+    for(unsigned shift = 0;; shift += 7) {
+        if(p == end || shift > 63)
+            return false;
+        uint8_t byte = *p++;
+        delta |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if(!(byte & 0x80))
+            break;
+    }
+    if(static_cast<size_t>(end - p) < payload_size(type))
+        return false;
+
+    e.type = type;
+    e.timestamp = last_timestamp + delta;
+    switch(type) {
+    case EventType::key_input:
+        e.key.key = get<int16_t>(p);
+        e.key.action = get<uint8_t>(p);
+        e.key.mods = get<uint8_t>(p);
+        break;
+    case EventType::mouse_input:
+        e.button.button = get<int16_t>(p);
+        e.button.action = get<uint8_t>(p);
+        e.button.mods = get<uint8_t>(p);
+        break;
+    case EventType::character:
+        e.codepoint = get<uint32_t>(p);
+        break;
+    case EventType::window_resize:
+        e.size.width = get<int32_t>(p);
+        e.size.height = get<int32_t>(p);
+        break;
+    case EventType::gamepad_connection:
+    case EventType::gamepad_button:
+    case EventType::gamepad_axis:
+        e.gamepad.pad = get<uint8_t>(p);
+        e.gamepad.code = get<uint8_t>(p);
+        e.gamepad.action = get<uint8_t>(p);
+        p += 1;
+        e.gamepad.value = get<float>(p);
+        break;
+    default:
+        e.position.x = get<double>(p);
+        e.position.y = get<double>(p);
+        break;
+    }
+    last_timestamp = e.timestamp;
+    offset = p - data;
+    return true;
+}
+
+void EventLogReader::rewind() {
+    Header h;
+    std::memcpy(&h, data, sizeof(h));
+    offset = h.header_size;
+    last_timestamp = start_timestamp;
+}
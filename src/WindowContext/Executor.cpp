@@ -0,0 +1,156 @@
+#include <WindowContext/Executor.hpp>
+#include <algorithm>
+
+using namespace io;
+
+namespace {
+
+thread_local const Executor* current_executor = nullptr;
+thread_local size_t current_worker = 0;
+thread_local const SerialQueue* current_queue = nullptr;
+
+// Events run per turn before a queue goes back behind the others.
+constexpr size_t batch_size = 64;
+
+}
+
+SerialQueue::SerialQueue(Executor& executor, EventHandler handler)
+    : executor(executor)
+    , handler(std::move(handler)) {}
+
+void SerialQueue::post(const InputEvent& e) {
+    {
+        std::lock_guard lock(mutex);
+        if(closed.load(std::memory_order_relaxed))
+            return;
+        events.push_back(e);
+        high_watermark = std::max(high_watermark, events.size());
+        if(scheduled)
+            return;
+        scheduled = true;
+    }
+    executor.submit(shared_from_this());
+}
+
+void SerialQueue::run() {
+    InputEvent batch[batch_size];
+    size_t n;
+    {
+        std::lock_guard lock(mutex);
+        n = closed ? 0 : std::min(events.size(), batch_size);
+        std::copy_n(events.begin(), n, batch);
+        events.erase(events.begin(), events.begin() + n);
+        running = true;
+    }
+    current_queue = this;
+    size_t i = 0;
+    auto t = n ? monotonic_ns() : 0;
+    for(; i < n && !closed.load(std::memory_order_relaxed); ++i) {
+        handler(batch[i]);
+        auto now = monotonic_ns();
+        counters->record(now - t);
+        t = now;
+    }
+    current_queue = nullptr;
+
+    bool more;
+    {
+        std::lock_guard lock(mutex);
+        delivered += i;
+        running = false;
+        more = !closed && !events.empty();
+        scheduled = more;
+    }
+    idle.notify_all();
+    if(more)
+        executor.submit(shared_from_this());
+}
+
+void SerialQueue::close() {
+    std::unique_lock lock(mutex);
+    closed = true;
+    events.clear();
+    if(current_queue != this)
+        idle.wait(lock, [this] { return !running; });
+}
+
+ListenerQueueStats SerialQueue::stats(SubscriptionToken token) {
+    std::lock_guard lock(mutex);
+    return {token, events.size(), high_watermark, delivered};
+}
+
+Executor::Executor(size_t thread_count) {
+    for(size_t i = 0; i < thread_count; ++i)
+        workers.push_back(std::make_unique<Worker>());
+    for(size_t i = 0; i < thread_count; ++i)
+        threads.emplace_back([this, i]() { worker_fn(i); });
+}
+
+Executor::~Executor() {
+    {
+        std::lock_guard lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(auto& t : threads)
+        t.join();
+}
+
+void Executor::submit(std::shared_ptr<SerialQueue> task) {
+    auto i = current_executor == this ? current_worker
+                                      : next_worker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        std::lock_guard lock(workers[i]->mutex);
+        workers[i]->tasks.push_back(std::move(task));
+    }
+    // Pairs with the sleepers increment in worker_fn: either the worker sees
+    // the task or this sees the sleeper.
+    pending.fetch_add(1);
+    if(sleepers.load()) {
+        { std::lock_guard lock(sleep_mutex); }
+        wake.notify_one();
+    }
+}
+
+std::shared_ptr<SerialQueue> Executor::take(size_t self) {
+    for(size_t k = 0; k < workers.size(); ++k) {
+        auto& w = *workers[(self + k) % workers.size()];
+        std::lock_guard lock(w.mutex);
+        if(w.tasks.empty())
+            continue;
+        auto task = std::move(w.tasks.front());
+        w.tasks.pop_front();
+        pending.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+    }
+    return nullptr;
+}
+
+void Executor::worker_fn(size_t self) {
+    current_executor = this;
+    current_worker = self;
+    for(;;) {
+        if(auto task = take(self)) {
+            task->run();
+            continue;
+        }
+        std::unique_lock lock(sleep_mutex);
+        sleepers.fetch_add(1);
+        wake.wait(lock, [this]() { return stopping || pending.load() > 0; });
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+        if(stopping)
+            return;
+    }
+}
+
+std::shared_ptr<Executor> Executor::acquire() {
+    static std::mutex m;
+    static std::weak_ptr<Executor> shared;
+    std::lock_guard lock(m);
+    auto p = shared.lock();
+    if(!p) {
+        p = std::make_shared<Executor>(std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2, 4));
+        shared = p;
+    }
+    return p;
+}
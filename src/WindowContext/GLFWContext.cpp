@@ -1,232 +1,470 @@
 #include <WindowContext/GLFWContext.hpp>
+#include <WindowContext/Waker.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
 
 using namespace io;
 
-template<typename ...Args>
-struct ICallback {
-    virtual void operator()(Args...) = 0;
-};
+static_assert(GLFW_KEY_LAST < InputState::key_count);
+static_assert(GLFW_MOUSE_BUTTON_LAST < InputState::button_count);
+static_assert(GLFW_JOYSTICK_LAST - GLFW_JOYSTICK_1 < InputState::gamepad_count);
+static_assert(GLFW_GAMEPAD_BUTTON_LAST < GamepadState::button_count);
+static_assert(GLFW_GAMEPAD_AXIS_LAST < GamepadState::axis_count);
 
-template<typename ...Args>
-struct FunctionCallback : ICallback<Args...>{
-    std::function<void(Args...)> fn;
-    void operator()(Args... args) { fn(args...); }
-};
+struct alignas(64) GLFWContext::WindowState {
+    EventDispatcher* events;
+    GamepadPoller* gamepads;
+    GLFWwindow* window{nullptr};
+    std::atomic_bool cursor_mode{false};
+    std::atomic_bool active{true};
+    // Set by any thread, applied by the pumping thread before its next wait.
+    std::atomic<uint32_t> callback_types{0};
+    std::atomic_bool callbacks_requested{false};
+    std::atomic_bool position_requested{false};
+    bool wants_gamepads{false};  // pumping thread, or while the pump is paused
+    bool produced{false};        // pump thread: this pass queued input
+    RelativeMotion relative_motion;
+    Waker waker;
 
+    WindowState(EventDispatcher* events, GamepadPoller* gamepads) : events(events), gamepads(gamepads) {}
 
-template<typename IFace, typename ...Args>
-struct PtrCallback : ICallback<Args...>{
-    IFace* ptr;
-    void (IFace::*fn)(Args...);
-    void operator()(Args... args) { (*ptr.*fn)(args...); }
-};
+    void push(const InputEvent& e) {
+        produced = true;
+        events->push(e);
+    }
 
-template<typename ...Args>
-struct CallbackUtils {
-    using IFace_t = ICallback<Args...>;
-    using IFaceUptr_t = std::unique_ptr<IFace_t>;
-
-    template<typename IListener, typename FN>
-    static IFaceUptr_t make(IListener* listener, FN fn) {
-        auto cb = std::make_unique<PtrCallback<IListener, Args...>>();
-        cb->ptr = listener;
-        cb->fn = fn;
-        return std::move(cb);
+    void set_center(const std::tuple<int, int>& v) {
+        relative_motion.set_center(std::get<0>(v), std::get<1>(v));
     }
-    static IFaceUptr_t make(std::function<void(Args...)> fn) {
-        auto cb = std::make_unique<FunctionCallback<Args...>>();
-        cb->fn = fn;
-        return std::move(cb);
+    void warp_to_center(GLFWwindow* window) {
+        glfwSetCursorPos(window, relative_motion.get_center_w(), relative_motion.get_center_h());
     }
 };
-using IKeyInputCallbackIUtils_t = CallbackUtils<int, int, int>;
-using ICursorPositionCallbackIUtils_t = CallbackUtils<double, double>;
-using IMouseMovementCallbackIUtils_t = CallbackUtils<double, double>;
-using IMouseInputCallbackIUtils_t = CallbackUtils<int, int, int>;
-using IWindowResizeCallbackIUtils_t = CallbackUtils<int, int>;
-using ICharacterInputCallbackUtils_t = CallbackUtils<uint32_t>;
-using IScrollInputCallbackUtils_t = CallbackUtils<double, double>;
-
-struct GLFWContext::Dispatcher {
-    static IKeyInputCallbackIUtils_t::IFaceUptr_t key_input_callback;
-    static ICursorPositionCallbackIUtils_t::IFaceUptr_t cursor_position_callback;
-    static IMouseMovementCallbackIUtils_t::IFaceUptr_t mouse_movement_callback;
-    static IMouseInputCallbackIUtils_t::IFaceUptr_t mouse_input_callback;
-    static IWindowResizeCallbackIUtils_t::IFaceUptr_t window_resize_callback;
-    static ICharacterInputCallbackUtils_t::IFaceUptr_t character_input_callback;
-    static IScrollInputCallbackUtils_t::IFaceUptr_t scroll_input_callback;
-    static std::atomic_bool cursor_mode;
-    static std::atomic_bool active;
-    static std::atomic_int center_w, center_h;
-
-    static void set_center(int w, int h) {
-        center_w = w/2;
-        center_h = h/2;
+
+// Owns glfwInit()/glfwTerminate() and, in thread mode, the thread that waits
+// for events of every window. GLFW calls that create or destroy windows are
+// made while that thread is paused, so they never overlap glfwWaitEvents().
+// Other threads never call into the pump's GLFW state directly: callback
+// changes and the cursor mode position are requested on the window and
+// applied by the pumping thread between waits.
+// GLFW has no gamepad input events, so while a window wants them and a
+// gamepad is connected the pump waits at most one gamepad poll interval and
+// reads every pad after each wait. Connections do come as events.
+class GLFWContext::Pump {
+    static inline Pump* instance{nullptr};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<WindowState*> windows;
+    size_t gamepad_windows{0};
+    // Pumping thread: connected gamepads, and whether one came or went since
+    // the pads were last read.
+    uint32_t connected_pads{0};
+    bool pads_changed{false};
+    GamepadReadings pads;
+    size_t pause_requests{0};
+    bool paused{false};
+    bool running{true};
+    std::thread t;
+
+    // Outside `mutex`, since handlers run by the pushes may pause the pump.
+    // `windows` only changes while the pump is paused or from such a
+    // handler, hence the index.
+    void poll_gamepads() {
+        for(int jid = GLFW_JOYSTICK_1; jid <= GLFW_JOYSTICK_LAST; ++jid) {
+            GLFWgamepadstate gs;
+            if(!glfwGetGamepadState(jid, &gs)) {
+                pads.clear(jid - GLFW_JOYSTICK_1);
+                continue;
+            }
+            uint16_t held = 0;
+            for(int b = 0; b <= GLFW_GAMEPAD_BUTTON_LAST; ++b)
+                held |= (gs.buttons[b] == GLFW_PRESS) << b;
+            pads.set(jid - GLFW_JOYSTICK_1, held, gs.axes);
+        }
+        auto now = monotonic_ns();
+        for(size_t i = 0; i < windows.size(); ++i) {
+            auto w = windows[i];
+            if(!w->wants_gamepads || !w->active.load(std::memory_order_relaxed))
+                continue;
+            if(w->gamepads->update(pads, now, [w](const InputEvent& e) { w->events->push_stamped(e); }))
+                w->produced = true;
+        }
+    }
+
+    void watch_gamepads(WindowState* w, bool val) {
+        if(w->wants_gamepads != val)
+            val ? ++gamepad_windows : --gamepad_windows;
+        w->wants_gamepads = val;
+    }
+
+    // Outside `mutex`, like poll_gamepads().
+    void apply_requests();
+
+    static void joystick_callback(int jid, int event) {
+        auto bit = 1u << (jid - GLFW_JOYSTICK_1);
+        if(event == GLFW_CONNECTED && glfwJoystickIsGamepad(jid))
+            instance->connected_pads |= bit;
+        else
+            instance->connected_pads &= ~bit;
+        instance->pads_changed = true;
+    }
+
+    // After a wait: reads the pads while polling, or once to report a
+    // connection or disconnection.
+    void read_gamepads(bool wanted) {
+        if(wanted && (connected_pads || std::exchange(pads_changed, false)))
+            poll_gamepads();
     }
-    static void set_center(const std::tuple<int, int>& v) {
-        set_center(std::get<0>(v), std::get<1>(v));
+
+    void thread_fn() {
+        std::unique_lock lock(mutex);
+        while(running) {
+            auto interval = gamepad_interval.load(std::memory_order_relaxed);
+            lock.unlock();
+            apply_requests();
+            bool wanted = gamepad_windows;
+            bool polling = wanted && connected_pads;
+            if(polling)
+                glfwWaitEventsTimeout(interval * 1e-9);
+            else
+                glfwWaitEvents();
+            read_gamepads(wanted);
+            lock.lock();
+            for(auto w : windows) {
+                w->events->count_wakeup();
+                w->events->publish_state();
+                // Timed wakeups that found the pads unchanged stay here.
+                if(std::exchange(w->produced, false) || !polling)
+                    w->waker.notify();
+            }
+            if(pause_requests) {
+                paused = true;
+                cv.notify_all();
+                cv.wait(lock, [this] { return !pause_requests || !running; });
+                paused = false;
+            }
+        }
+    }
+public:
+    const PumpMode mode;
+    std::atomic<uint64_t> gamepad_interval{default_gamepad_poll_interval};
+
+    // Holds the pump thread between two glfwWaitEvents() calls. On the pump
+    // thread itself, i.e. from an inline handler, it is already between them.
+    class Pause {
+        Pump& pump;
+        std::unique_lock<std::mutex> lock;
+    public:
+        explicit Pause(Pump& pump) : pump(pump), lock(pump.mutex) {
+            ++pump.pause_requests;
+            if(pump.t.joinable() && pump.t.get_id() != std::this_thread::get_id()) {
+                glfwPostEmptyEvent();
+                pump.cv.wait(lock, [&pump] { return pump.paused; });
+            }
+        }
+        ~Pause() {
+            --pump.pause_requests;
+            lock.unlock();
+            pump.cv.notify_all();
+        }
+        void add(WindowState* w) {
+            pump.windows.push_back(w);
+        }
+        void remove(WindowState* w) {
+            pump.watch_gamepads(w, false);
+            pump.windows.erase(std::remove(pump.windows.begin(), pump.windows.end(), w),
+                               pump.windows.end());
+        }
+    };
+
+    explicit Pump(PumpMode mode) : mode(mode) {
+        if(!glfwInit())
+            throw std::runtime_error("Couldn't init glfw");
+        instance = this;
+        for(int jid = GLFW_JOYSTICK_1; jid <= GLFW_JOYSTICK_LAST; ++jid)
+            if(glfwJoystickIsGamepad(jid))
+                connected_pads |= 1u << (jid - GLFW_JOYSTICK_1);
+        glfwSetJoystickCallback(joystick_callback);
+        if(mode == PumpMode::thread)
+            t = std::thread([this]() { thread_fn(); });
+    }
+    ~Pump() {
+        if(t.joinable()) {
+            {
+                std::lock_guard lock(mutex);
+                running = false;
+            }
+            cv.notify_all();
+            glfwPostEmptyEvent();
+            t.join();
+        }
+        glfwSetJoystickCallback(nullptr);
+        instance = nullptr;
+        glfwTerminate();
+    }
+
+    // Main-thread modes: processes pending events, waiting until `deadline`
+    // (0 for no deadline) in wait_deadline mode.
+    void pump_events(uint64_t deadline) {
+        apply_requests();
+        bool wanted = gamepad_windows;
+        bool polling = wanted && connected_pads;
+        if(mode == PumpMode::poll) {
+            glfwPollEvents();
+            read_gamepads(wanted);
+        } else if(!polling) {
+            if(!deadline) {
+                glfwWaitEvents();
+            } else {
+                auto now = monotonic_ns();
+                glfwWaitEventsTimeout(deadline > now ? (deadline - now) * 1e-9 : 0.0);
+            }
+            // Requests from other threads wake the wait.
+            apply_requests();
+            read_gamepads(wanted);
+        } else {
+            // Wait in poll intervals until something is queued or the
+            // deadline passes.
+            auto interval = gamepad_interval.load(std::memory_order_relaxed);
+            for(;;) {
+                auto now = monotonic_ns();
+                auto until = deadline ? std::min(deadline, now + interval) : now + interval;
+                glfwWaitEventsTimeout(until > now ? (until - now) * 1e-9 : 0.0);
+                apply_requests();
+                poll_gamepads();
+                bool produced = false;
+                for(auto w : windows)
+                    produced |= std::exchange(w->produced, false);
+                if(produced || (deadline && monotonic_ns() >= deadline))
+                    break;
+                std::lock_guard lock(mutex);
+                for(auto w : windows)
+                    w->events->count_wakeup();
+            }
+        }
+        std::lock_guard lock(mutex);
+        for(auto w : windows) {
+            w->produced = false;
+            w->events->count_wakeup();
+            w->events->publish_state();
+        }
+    }
+
+    static std::shared_ptr<Pump> acquire(PumpMode mode) {
+        static std::mutex m;
+        static std::weak_ptr<Pump> shared;
+        std::lock_guard lock(m);
+        auto p = shared.lock();
+        if(!p) {
+            p = std::make_shared<Pump>(mode);
+            shared = p;
+        } else if(p->mode != mode) {
+            throw std::runtime_error("Every GLFW window must use the same pump mode");
+        }
+        return p;
+    }
+};
+
+struct GLFWContext::Callbacks {
+    static WindowState& state(GLFWwindow* window) {
+        return *static_cast<WindowState*>(glfwGetWindowUserPointer(window));
     }
 
     static void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods) {
-        if(!active.load()) return;
-        if(key_input_callback)
-            (*key_input_callback)(key, action, mods);
+        auto& s = state(window);
+        if(!s.active.load(std::memory_order_relaxed)) {
+            s.events->count_unfocused(EventType::key_input);
+            return;
+        }
+        s.push(InputEvent::make_key_input(key, action, mods));
     }
     static void cursor_callback(GLFWwindow* window, double xpos, double ypos) {
-        if(!active.load()) return;
-        if(cursor_mode.load() && cursor_position_callback) {
-            (*cursor_position_callback)(xpos, ypos);
+        auto& s = state(window);
+        if(!s.active.load(std::memory_order_relaxed)) {
+            s.events->count_unfocused(s.cursor_mode.load(std::memory_order_relaxed)
+                                      ? EventType::cursor_position : EventType::mouse_movement);
+            return;
         }
-        else if(mouse_movement_callback) {
-            (*mouse_movement_callback)(xpos - center_w, ypos - center_h);
-            glfwSetCursorPos(window, center_w, center_h);
+        if(s.cursor_mode.load(std::memory_order_relaxed)) {
+            s.push(InputEvent::make_cursor_position(xpos, ypos));
+        }
+        else {
+            double dx, dy;
+            bool warp;
+            if(s.relative_motion.convert(xpos, ypos, dx, dy, warp))
+                s.push(InputEvent::make_mouse_movement(dx, dy));
+            if(warp)
+                s.warp_to_center(window);
         }
     }
     static void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
-        if(!active.load()) return;
-        if(mouse_input_callback)
-            (*mouse_input_callback)(button, action, mods);
+        auto& s = state(window);
+        if(!s.active.load(std::memory_order_relaxed)) {
+            s.events->count_unfocused(EventType::mouse_input);
+            return;
+        }
+        s.push(InputEvent::make_mouse_input(button, action, mods));
     }
     static void window_size_callback(GLFWwindow* window, int width, int height) {
-        set_center(width, height);
-        if(!cursor_mode.load())
-            glfwSetCursorPos(window, center_w, center_h);
-        if(window_resize_callback)
-            (*window_resize_callback)(width, height);
+        auto& s = state(window);
+        s.relative_motion.set_center(width, height);
+        if(!s.cursor_mode.load(std::memory_order_relaxed) && !s.relative_motion.is_warp_free())
+            s.warp_to_center(window);
+        s.push(InputEvent::make_window_resize(width, height));
     }
     static void character_callback(GLFWwindow* window, uint32_t codepoint) {
-        if(!active.load()) return;
-        if(character_input_callback)
-            (*character_input_callback)(codepoint);
+        auto& s = state(window);
+        if(!s.active.load(std::memory_order_relaxed)) {
+            s.events->count_unfocused(EventType::character);
+            return;
+        }
+        s.push(InputEvent::make_character(codepoint));
     }
     static void scroll_callback(GLFWwindow* window, double xdelta, double ydelta) {
-        if(!active.load()) return;
-        if(scroll_input_callback)
-            (*scroll_input_callback)(xdelta, ydelta);
+        auto& s = state(window);
+        if(!s.active.load(std::memory_order_relaxed)) {
+            s.events->count_unfocused(EventType::scroll_input);
+            return;
+        }
+        s.push(InputEvent::make_scroll_input(xdelta, ydelta));
     }
     static void focus_callback(GLFWwindow* window, int focused) {
-        active = GLFW_TRUE == focused;
+        auto& s = state(window);
+        s.active = GLFW_TRUE == focused;
+        s.produced = true;
+        if(!s.active) {
+            s.events->release_all();
+            // Held buttons and tilted sticks are reported again on return.
+            s.gamepads->release();
+        }
     }
-};
-
-IKeyInputCallbackIUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::key_input_callback{nullptr};
-ICursorPositionCallbackIUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::cursor_position_callback{nullptr};
-IMouseMovementCallbackIUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::mouse_movement_callback{nullptr};
-IMouseInputCallbackIUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::mouse_input_callback{nullptr};
-IWindowResizeCallbackIUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::window_resize_callback{nullptr};
-ICharacterInputCallbackUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::character_input_callback{nullptr};
-IScrollInputCallbackUtils_t::IFaceUptr_t
-    GLFWContext::Dispatcher::scroll_input_callback{nullptr};
-
-std::atomic_bool GLFWContext::Dispatcher::cursor_mode{false};
-std::atomic_bool GLFWContext::Dispatcher::active{true};
-std::atomic_int GLFWContext::Dispatcher::center_w, GLFWContext::Dispatcher::center_h;
-
-void GLFWContext::input_listener_thread_fn() {
-    glfwSetKeyCallback(window, Dispatcher::key_callback);
-    glfwSetCursorPosCallback(window, Dispatcher::cursor_callback);
-    glfwSetMouseButtonCallback(window, Dispatcher::mouse_button_callback);
-    glfwSetWindowSizeCallback(window, Dispatcher::window_size_callback);
-    glfwSetCharCallback(window, Dispatcher::character_callback);
-    glfwSetScrollCallback(window, Dispatcher::scroll_callback);
-    glfwSetWindowFocusCallback(window, Dispatcher::focus_callback);
-    while(running) {
-        glfwWaitEvents();
+    static void close_callback(GLFWwindow* window) {
+        state(window).produced = true;
     }
-}
 
-GLFWContext::GLFWContext() {
-    if (!glfwInit())
-        throw std::runtime_error("Couldn't init glfw");
-
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    // Returns whether the window wants gamepad events.
+    static bool install(WindowState& s, uint32_t types) {
+        auto wants = [types](auto... t) { return ((types & event_bit(t)) || ...); };
+        glfwSetKeyCallback(s.window, wants(EventType::key_input) ? key_callback : nullptr);
+        auto cursor = wants(EventType::cursor_position, EventType::mouse_movement) ? cursor_callback : nullptr;
+        // The cursor moved unobserved while its callback was off.
+        if(!glfwSetCursorPosCallback(s.window, cursor) && cursor)
+            s.relative_motion.restart();
+        glfwSetMouseButtonCallback(s.window, wants(EventType::mouse_input) ? mouse_button_callback : nullptr);
+        glfwSetCharCallback(s.window, wants(EventType::character) ? character_callback : nullptr);
+        glfwSetScrollCallback(s.window, wants(EventType::scroll_input) ? scroll_callback : nullptr);
+        return wants(EventType::gamepad_connection, EventType::gamepad_button, EventType::gamepad_axis);
+    }
+    // Produced like any sample, so it is tracked and recorded.
+    static void push_position(WindowState& s) {
+        double xpos, ypos;
+        glfwGetCursorPos(s.window, &xpos, &ypos);
+        s.push(InputEvent::make_cursor_position(xpos, ypos));
+    }
+};
 
-    window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
-    if (!window) {
-        glfwTerminate();
-        throw std::runtime_error("Couldn't create window");
+void GLFWContext::Pump::apply_requests() {
+    for(size_t i = 0; i < windows.size(); ++i) {
+        auto w = windows[i];
+        if(w->callbacks_requested.load(std::memory_order_relaxed)
+           && w->callbacks_requested.exchange(false, std::memory_order_acquire))
+            watch_gamepads(w, Callbacks::install(*w, w->callback_types.load(std::memory_order_relaxed)));
+        if(w->position_requested.load(std::memory_order_relaxed)
+           && w->position_requested.exchange(false, std::memory_order_acquire)
+           && w->cursor_mode.load(std::memory_order_relaxed))
+            Callbacks::push_position(*w);
     }
-    glfwMakeContextCurrent(window);
+}
 
-    Dispatcher::set_center(get_dimensions());
+GLFWContext::GLFWContext(int width, int height, const std::string& title, PumpMode mode)
+    : WindowContextBase(default_event_queue_capacity)
+    , pump(Pump::acquire(mode))
+    , state(std::make_unique<WindowState>(&events, &gamepads)) {
+    {
+        Pump::Pause pause(*pump);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
 
-    running = true;
-    t = std::thread([this](){input_listener_thread_fn();});
+        window = glfwCreateWindow(width, height, title.c_str(), NULL, NULL);
+        if (!window)
+            throw std::runtime_error("Couldn't create window");
+        glfwMakeContextCurrent(window);
 
-    if (glfwRawMouseMotionSupported()) {
-        // std::cout << "Raw mouse pos is supported" << std::endl;
-        glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
-    } else {
-        // std::cout << "Raw mouse pos is not supported" << std::endl;
+        state->window = window;
+        glfwSetWindowUserPointer(window, state.get());
+        // Needed for the cursor center and focus tracking; the rest come and
+        // go with interest in their event types.
+        glfwSetWindowSizeCallback(window, Callbacks::window_size_callback);
+        glfwSetWindowFocusCallback(window, Callbacks::focus_callback);
+        glfwSetWindowCloseCallback(window, Callbacks::close_callback);
+        pause.add(state.get());
     }
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_HIDDEN);
+    state->set_center(get_dimensions());
+    set_cursor_mode(false);
+    events.set_interest_callback(InterestCallback::bind<&GLFWContext::request_callbacks>(this));
 }
 
-GLFWContext::~GLFWContext() {
-    running = false;
+// Any thread, including an inline handler on the pumping thread; the pump
+// installs the callbacks before its next wait.
+void GLFWContext::request_callbacks(uint32_t types) {
+    state->callback_types.store(types, std::memory_order_relaxed);
+    state->callbacks_requested.store(true, std::memory_order_release);
     glfwPostEmptyEvent();
-    t.join();
-    if (window)
-        glfwTerminate();
 }
 
-void GLFWContext::set_key_input_listener(IKeyInputListener* il) {
-    Dispatcher::key_input_callback =
-        IKeyInputCallbackIUtils_t::make(il, &IKeyInputListener::serve_key_input);
-}
-void GLFWContext::set_cursor_position_listener(ICursorPositionListener* pl) {
-    Dispatcher::cursor_position_callback =
-        ICursorPositionCallbackIUtils_t::make(pl, &ICursorPositionListener::serve_cursor_position);
-}
-void GLFWContext::set_mouse_movement_listener(IMouseMovementListener* ml) {
-    Dispatcher::mouse_movement_callback =
-        IMouseMovementCallbackIUtils_t::make(ml, &IMouseMovementListener::serve_mouse_movement);
-}
-void GLFWContext::set_mouse_input_listener(IMouseInputListener* ml) {
-    Dispatcher::mouse_input_callback =
-        IMouseInputCallbackIUtils_t::make(ml, &IMouseInputListener::serve_mouse_input);
-}
-void GLFWContext::set_window_resized_listener(IWindowResizeListener* rl) {
-    Dispatcher::window_resize_callback =
-        IWindowResizeCallbackIUtils_t::make(rl, &IWindowResizeListener::serve_window_resized);
-}
-void GLFWContext::set_character_listener(ICharacterInputListener* cl) {
-    Dispatcher::character_input_callback =
-        ICharacterInputCallbackUtils_t::make(cl, &ICharacterInputListener::serve_character);
-}
-void GLFWContext::set_scroll_input_listener(IScrollIuputListener *sl) {
-    Dispatcher::scroll_input_callback =
-        IScrollInputCallbackUtils_t::make(sl, &IScrollIuputListener::serve_scroll_input);
+GLFWContext::~GLFWContext() {
+    events.set_interest_callback(nullptr);
+    Pump::Pause pause(*pump);
+    pause.remove(state.get());
+    glfwDestroyWindow(window);
 }
 
 void GLFWContext::set_cursor_mode(bool val) {
-    Dispatcher::cursor_mode = val;
+    state->cursor_mode = val;
     if(val) {
+        state->relative_motion.set_warp_free(false);
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
         glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_FALSE);
-        double xpos, ypos;
-        glfwGetCursorPos(window, &xpos, &ypos);
-        Dispatcher::cursor_callback(window, xpos, ypos);
+        // The pumping thread produces the starting position, so the event
+        // queue keeps a single producer.
+        state->position_requested.store(true, std::memory_order_release);
+        glfwPostEmptyEvent();
     } else {
         glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-        if (glfwRawMouseMotionSupported())
+        bool raw = glfwRawMouseMotionSupported();
+        if (raw)
             glfwSetInputMode(window, GLFW_RAW_MOUSE_MOTION, GLFW_TRUE);
+        else
+            state->warp_to_center(window);
+        state->relative_motion.set_warp_free(raw);
     }
 }
 
+void GLFWContext::set_gamepad_poll_interval(uint64_t interval_ns) {
+    pump->gamepad_interval = std::max<uint64_t>(interval_ns, 1);
+}
+
 void GLFWContext::set_sticky_keys(bool val) {
     glfwSetInputMode(window, GLFW_STICKY_KEYS, (val ? GLFW_TRUE : GLFW_FALSE));
 }
 
+size_t GLFWContext::paste_clipboard() {
+    auto text = glfwGetClipboardString(window);
+    return text ? paste_text(text) : 0;
+}
+
 bool GLFWContext::update() {
-    glfwPollEvents();
+    auto deadline = next_frame_deadline();
+    if(pump->mode == PumpMode::thread)
+        state->waker.wait_until(deadline);
+    else
+        pump->pump_events(deadline);
+    drain_events();
     if(glfwWindowShouldClose(window))
         return false;
 
@@ -234,31 +472,8 @@ bool GLFWContext::update() {
     return true;
 }
 
-IWindowContext &GLFWContext::get() {
-    static GLFWContext i;
-    return i;
-}
-
-void GLFWContext::set_key_input_callback(std::function<void (int, int, int)> fn) {
-    Dispatcher::key_input_callback = IKeyInputCallbackIUtils_t::make(fn);
-}
-void GLFWContext::set_cursor_position_callback(std::function<void (double, double)> fn) {
-    Dispatcher::cursor_position_callback = ICursorPositionCallbackIUtils_t::make(fn);
-}
-void GLFWContext::set_mouse_movement_callback(std::function<void (double, double)> fn) {
-    Dispatcher::mouse_movement_callback = IMouseMovementCallbackIUtils_t::make(fn);
-}
-void GLFWContext::set_mouse_input_callback(std::function<void (int, int, int)> fn) {
-    Dispatcher::mouse_input_callback = IMouseInputCallbackIUtils_t::make(fn);
-}
-void GLFWContext::set_window_resized_callback(std::function<void (int, int)> fn) {
-    Dispatcher::window_resize_callback = IWindowResizeCallbackIUtils_t::make(fn);
-}
-void GLFWContext::set_character_callback(std::function<void (uint32_t)> fn) {
-    Dispatcher::character_input_callback = ICharacterInputCallbackUtils_t::make(fn);
-}
-void GLFWContext::set_scroll_input_callback(std::function<void (double, double)> fn){
-    Dispatcher::scroll_input_callback = IScrollInputCallbackUtils_t::make(fn);
+MotionStats GLFWContext::get_motion_stats() {
+    return state->relative_motion.stats();
 }
 
 std::tuple<int, int> GLFWContext::get_dimensions() {
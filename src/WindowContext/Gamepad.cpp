@@ -0,0 +1,123 @@
+#include <WindowContext/Gamepad.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IO_GAMEPAD_X86 1
+#endif
+
+using namespace io;
+
+namespace {
+
+constexpr size_t pad_count = GamepadReadings::pad_count;
+
+// x = raw * gain + bias maps an axis onto -1..1 (sticks) or 0..1 (triggers);
+// the output is sign(x) * t * (linear + cubic * t^2) with t the travel past
+// the deadzone, rescaled to 0..1.
+struct Coefficients {
+    float gain, bias, deadzone, scale, linear, cubic;
+
+    Coefficients(const GamepadResponse& r, bool trigger)
+        : gain(trigger ? 0.5f : 1.0f)
+        , bias(trigger ? 0.5f : 0.0f)
+        , deadzone(r.deadzone)
+        , scale(1.0f / (1.0f - r.deadzone))
+        , linear(1.0f - r.curve)
+        , cubic(r.curve) {}
+};
+
+#ifdef IO_GAMEPAD_X86
+
+static_assert(pad_count % 4 == 0);
+
+// Rows are one axis of every pad; returns bit p set where out[p] != prev[p].
+__attribute__((target("sse2")))
+uint16_t respond(const float* in, const float* prev, float* out, const Coefficients& c) {
+    const __m128 gain = _mm_set1_ps(c.gain), bias = _mm_set1_ps(c.bias);
+    const __m128 deadzone = _mm_set1_ps(c.deadzone), scale = _mm_set1_ps(c.scale);
+    const __m128 linear = _mm_set1_ps(c.linear), cubic = _mm_set1_ps(c.cubic);
+    const __m128 one = _mm_set1_ps(1.0f), zero = _mm_setzero_ps(), sign = _mm_set1_ps(-0.0f);
+    unsigned moved = 0;
+    for(size_t p = 0; p < pad_count; p += 4) {
+        __m128 x = _mm_add_ps(_mm_mul_ps(_mm_load_ps(in + p), gain), bias);
+        __m128 a = _mm_andnot_ps(sign, x);
+        // maxps returns its second operand for NaN.
+        __m128 t = _mm_min_ps(_mm_mul_ps(_mm_max_ps(_mm_sub_ps(a, deadzone), zero), scale), one);
+        __m128 y = _mm_mul_ps(t, _mm_add_ps(linear, _mm_mul_ps(cubic, _mm_mul_ps(t, t))));
+        // Copy the sign of x, except onto 0 so that rest is never -0.
+        y = _mm_or_ps(y, _mm_and_ps(_mm_and_ps(x, sign), _mm_cmpgt_ps(y, zero)));
+        _mm_store_ps(out + p, y);
+        moved |= _mm_movemask_ps(_mm_cmpneq_ps(y, _mm_load_ps(prev + p))) << p;
+    }
+    return moved;
+}
+
+#else
+
+uint16_t respond(const float* in, const float* prev, float* out, const Coefficients& c) {
+    uint16_t moved = 0;
+    for(size_t p = 0; p < pad_count; ++p) {
+        float x = in[p] * c.gain + c.bias;
+        // Written so that NaN reads as rest, as in the vector version.
+        float t = std::min(std::max(0.0f, std::fabs(x) - c.deadzone) * c.scale, 1.0f);
+        float y = t * (c.linear + c.cubic * t * t);
+        out[p] = x < 0 && y > 0 ? -y : y;
+        moved |= (out[p] != prev[p]) << p;
+    }
+    return moved;
+}
+
+#endif
+
+void check(const GamepadResponse& r) {
+    if(!(r.deadzone >= 0.0f && r.deadzone < 1.0f) || !(r.curve >= 0.0f && r.curve <= 1.0f))
+        throw std::invalid_argument("Gamepad deadzone must be in [0, 1) and curve in [0, 1]");
+}
+
+}
+
+GamepadReadings::GamepadReadings() {
+    for(size_t pad = 0; pad < pad_count; ++pad)
+        clear(static_cast<int>(pad));
+}
+
+void GamepadReadings::set(int pad, uint16_t held, const float* values) {
+    connected |= 1 << pad;
+    buttons[pad] = held;
+    for(size_t a = 0; a < axis_count; ++a)
+        axes[a][pad] = values[a];
+}
+
+void GamepadReadings::clear(int pad) {
+    connected &= ~(1 << pad);
+    buttons[pad] = 0;
+    for(size_t a = 0; a < axis_count; ++a)
+        axes[a][pad] = a < stick_axis_count ? 0.0f : -1.0f;
+}
+
+void GamepadPoller::set_stick_response(const GamepadResponse& r) {
+    check(r);
+    stick_response.store(r, std::memory_order_relaxed);
+}
+
+void GamepadPoller::set_trigger_response(const GamepadResponse& r) {
+    check(r);
+    trigger_response.store(r, std::memory_order_relaxed);
+}
+
+void GamepadPoller::filter(const GamepadReadings& r, std::array<uint16_t, axis_count>& moved) {
+    const Coefficients sticks(stick_response.load(std::memory_order_relaxed), false);
+    const Coefficients triggers(trigger_response.load(std::memory_order_relaxed), true);
+    for(size_t a = 0; a < axis_count; ++a) {
+        auto& c = a < GamepadReadings::stick_axis_count ? sticks : triggers;
+        moved[a] = respond(r.axes[a], axes[a], filtered[a], c);
+    }
+}
+
+void GamepadPoller::release() {
+    buttons = {};
+    for(auto& row : axes)
+        std::fill(std::begin(row), std::end(row), 0.0f);
+}
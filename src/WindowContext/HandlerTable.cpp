@@ -0,0 +1,170 @@
+#include <WindowContext/HandlerTable.hpp>
+#include <algorithm>
+
+using namespace io;
+
+template<typename FN>
+void HandlerTable::modify(EpochReclaimer& reclaimer, EventType type, FN&& fn) {
+    auto& slot = lists[static_cast<size_t>(type)];
+    auto list = std::make_unique<List>();
+    // Writers are serialized by `mutex` and only writers retire lists, so the
+    // current one stays alive here without pinning.
+    if(auto current = slot.load()) {
+        list->entries = current->entries;
+        auto counts = calls(*current);
+        for(size_t i = 0; i < counts.size(); ++i) {
+            auto& e = list->entries[i];
+            e.base_calls = e.rejected = e.consumed = {};
+            e.base_calls.add(counts[i]);
+        }
+    }
+    fn(list->entries);
+    slot.store(reclaimer, list->entries.empty() ? nullptr : std::move(list));
+}
+
+void HandlerTable::insert(std::vector<Entry>& entries, Entry e) {
+    auto it = std::find_if(entries.begin(), entries.end(),
+                           [&e](const Entry& o) { return o.priority < e.priority; });
+    entries.insert(it, std::move(e));
+}
+
+std::vector<uint64_t> HandlerTable::calls(const List& list) {
+    std::vector<uint64_t> counts;
+    uint64_t dispatches = list.dispatches.get(), consumed = 0;
+    for(auto& e : list.entries) {
+        // Clamped, as the counters are read while they change.
+        auto reached = dispatches - std::min(dispatches, consumed + e.rejected.get());
+        counts.push_back(e.base_calls.get() + reached);
+        consumed += e.consumed.get();
+    }
+    return counts;
+}
+
+SubscriptionToken HandlerTable::subscribe(EpochReclaimer& reclaimer, EventType type,
+                                          EventHandler handler, int priority, const EventFilter& filter,
+                                          std::shared_ptr<ListenerCounters> external) {
+    std::lock_guard lk(mutex);
+    auto id = next_id++;
+    modify(reclaimer, type, [&](std::vector<Entry>& entries) {
+        Entry e;
+        e.handler = std::move(handler);
+        e.filtered = !filter.is_trivial();
+        e.filter = filter;
+        e.priority = priority;
+        e.id = id;
+        e.external = std::move(external);
+        insert(entries, std::move(e));
+    });
+    return {type, id};
+}
+
+bool HandlerTable::unsubscribe(EpochReclaimer& reclaimer, SubscriptionToken token) {
+    std::lock_guard lk(mutex);
+    bool found = false;
+    modify(reclaimer, token.type, [&](std::vector<Entry>& entries) {
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [&token](const Entry& e) { return e.id == token.id; });
+        if(it == entries.end())
+            return;
+        entries.erase(it);
+        found = true;
+    });
+    return found;
+}
+
+void HandlerTable::replace_slot(EpochReclaimer& reclaimer, EventType type, Entry e, bool set) {
+    std::lock_guard lk(mutex);
+    uint64_t id = static_cast<uint64_t>(type);
+    modify(reclaimer, type, [&](std::vector<Entry>& entries) {
+        auto it = std::find_if(entries.begin(), entries.end(),
+                               [id](const Entry& e) { return e.id == id; });
+        if(it != entries.end())
+            entries.erase(it);
+        if(set) {
+            e.id = id;
+            insert(entries, std::move(e));
+        }
+    });
+}
+
+void HandlerTable::set_slot(EpochReclaimer& reclaimer, EventType type, EventHandler handler) {
+    Entry e;
+    bool set = bool(handler);
+    e.handler = std::move(handler);
+    replace_slot(reclaimer, type, std::move(e), set);
+}
+
+void HandlerTable::set_slot(EpochReclaimer& reclaimer, EventType type, SlotCallback callback) {
+    Entry e;
+    bool set = !std::holds_alternative<std::monostate>(callback);
+    e.slot = std::move(callback);
+    replace_slot(reclaimer, type, std::move(e), set);
+}
+
+void HandlerTable::call_slot(const SlotCallback& slot, const InputEvent& e) {
+    if(auto fn = std::get_if<Delegate<void(int, int, int)>>(&slot)) {
+        if(e.type == EventType::key_input)
+            (*fn)(e.key.key, e.key.action, e.key.mods);
+        else
+            (*fn)(e.button.button, e.button.action, e.button.mods);
+    } else if(auto fn = std::get_if<Delegate<void(double, double)>>(&slot)) {
+        (*fn)(e.position.x, e.position.y);
+    } else if(auto fn = std::get_if<Delegate<void(int, int)>>(&slot)) {
+        (*fn)(e.size.width, e.size.height);
+    }
+}
+
+void HandlerTable::add_interest(EventAdmission::Builder& b) {
+    std::lock_guard lk(mutex);
+    for(size_t t = 0; t < event_type_count; ++t) {
+        // Only writers replace lists and they hold `mutex`, as in modify().
+        auto list = lists[t].load();
+        if(!list)
+            continue;
+        for(auto& entry : list->entries)
+            b.add(static_cast<EventType>(t), entry.filtered ? &entry.filter : nullptr);
+    }
+}
+
+void HandlerTable::add_listener_stats(std::vector<ListenerStats>& out, ListenerAffinity affinity,
+                                      ListenerAffinity external_affinity) const {
+    std::lock_guard lk(mutex);
+    for(size_t t = 0; t < event_type_count; ++t) {
+        auto list = lists[t].load();
+        if(!list)
+            continue;
+        auto counts = calls(*list);
+        for(size_t i = 0; i < counts.size(); ++i) {
+            auto& entry = list->entries[i];
+            SubscriptionToken token{static_cast<EventType>(t), entry.id};
+            if(auto& c = entry.external) {
+                out.push_back({token, external_affinity, c->calls.get(), c->total_ns.get(), c->max_ns.get()});
+                continue;
+            }
+            // Extrapolated from the timed calls.
+            auto& timing = entry.timing;
+            auto timed = timing.calls.get();
+            auto total = timed ? static_cast<uint64_t>(double(timing.total_ns.get()) * counts[i] / timed) : 0;
+            out.push_back({token, affinity, counts[i], total, timing.max_ns.get()});
+        }
+    }
+}
+
+bool HandlerTable::dispatch_timed(const List& list, const InputEvent& e) const {
+    auto t = monotonic_ns();
+    for(auto& entry : list.entries) {
+        if(entry.filtered && !entry.filter.matches(e)) {
+            entry.rejected.add();
+            continue;
+        }
+        bool consumed = entry.call(e);
+        auto now = monotonic_ns();
+        entry.timing.record(now - t);
+        t = now;
+        if(consumed) {
+            entry.consumed.add();
+            return true;
+        }
+    }
+    return false;
+}
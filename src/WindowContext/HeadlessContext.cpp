@@ -0,0 +1,103 @@
+#include <WindowContext/HeadlessContext.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace io;
+
+HeadlessContext::HeadlessContext(int width, int height, size_t event_queue_capacity)
+    : WindowContextBase(event_queue_capacity)
+    , width(width)
+    , height(height) {
+    relative_motion.set_center(width, height);
+    set_cursor_mode(false);
+}
+
+void HeadlessContext::produce(const InputEvent& e) {
+    switch(e.type) {
+    case EventType::cursor_position:
+        if(!cursor_mode) {
+            double dx, dy;
+            bool warp;
+            if(relative_motion.convert(e.position.x, e.position.y, dx, dy, warp)) {
+                auto m = InputEvent::make_mouse_movement(dx, dy);
+                m.timestamp = e.timestamp;
+                events.push_stamped(m);
+            }
+            return;
+        }
+        break;
+    case EventType::window_resize:
+        width = e.size.width;
+        height = e.size.height;
+        relative_motion.set_center(width, height);
+        break;
+    default:
+        break;
+    }
+    events.push_stamped(e);
+}
+
+void HeadlessContext::inject(InputEvent e) {
+    if(!e.timestamp)
+        e.timestamp = monotonic_ns();
+    produce(e);
+    events.publish_state();
+}
+
+void HeadlessContext::inject(const InputEvent* first, size_t count) {
+    auto now = monotonic_ns();
+    for(auto e = first, end = first + count; e != end; ++e) {
+        if(e->timestamp) {
+            produce(*e);
+        } else {
+            auto stamped = *e;
+            stamped.timestamp = now;
+            produce(stamped);
+        }
+    }
+    events.publish_state();
+}
+
+void HeadlessContext::set_gamepad(int pad, uint16_t buttons,
+                                  const std::array<float, GamepadState::axis_count>& axes) {
+    if(!InputState::valid_gamepad(pad))
+        throw std::out_of_range("No gamepad slot " + std::to_string(pad));
+    pads.set(pad, buttons, axes.data());
+}
+
+void HeadlessContext::remove_gamepad(int pad) {
+    if(!InputState::valid_gamepad(pad))
+        throw std::out_of_range("No gamepad slot " + std::to_string(pad));
+    pads.clear(pad);
+}
+
+void HeadlessContext::add_generator(std::unique_ptr<IEventGenerator> generator) {
+    generators.push_back(std::move(generator));
+}
+
+void HeadlessContext::clear_generators() {
+    generators.clear();
+}
+
+void HeadlessContext::set_cursor_mode(bool val) {
+    cursor_mode = val;
+    // There is no pointer to warp, so movement is always taken between samples.
+    relative_motion.set_warp_free(!val);
+}
+
+bool HeadlessContext::update() {
+    if(auto deadline = next_frame_deadline())
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+    auto now = monotonic_ns();
+    if(!generators.empty()) {
+        InputEventCallback emit = [this](const InputEvent& e) { produce(e); };
+        for(auto& g : generators)
+            g->generate(now, emit);
+    }
+    gamepads.update(pads, now, [this](const InputEvent& e) { produce(e); });
+    events.publish_state();
+    events.count_wakeup();
+    drain_events();
+    return !closed;
+}
@@ -0,0 +1,207 @@
+#include <WindowContext/InputState.hpp>
+
+using namespace io;
+
+namespace {
+constexpr int release_action = 0;
+constexpr int press_action = 1;
+}
+
+void InputStateTracker::Edges::merge(const Edges& o) {
+    keys_pressed |= o.keys_pressed;
+    keys_released |= o.keys_released;
+    buttons_pressed |= o.buttons_pressed;
+    buttons_released |= o.buttons_released;
+    motion_dx += o.motion_dx;
+    motion_dy += o.motion_dy;
+    scroll_dx += o.scroll_dx;
+    scroll_dy += o.scroll_dy;
+    for(size_t i = 0; i < InputState::gamepad_count; ++i) {
+        pad_pressed[i] |= o.pad_pressed[i];
+        pad_released[i] |= o.pad_released[i];
+    }
+}
+
+void InputStateTracker::key(int key, int action, int mods, uint64_t timestamp) {
+    levels.mods = mods;
+    levels.timestamp = timestamp;
+    dirty = true;
+    if(!InputState::valid_key(key))
+        return;
+    if(action == press_action) {
+        levels.keys.set(key);
+        pending.keys_pressed.set(key);
+    } else if(action == release_action) {
+        levels.keys.reset(key);
+        pending.keys_released.set(key);
+    }
+}
+
+void InputStateTracker::button(int button, int action, int mods, uint64_t timestamp) {
+    levels.mods = mods;
+    levels.timestamp = timestamp;
+    dirty = true;
+    if(!InputState::valid_button(button))
+        return;
+    uint8_t bit = 1 << button;
+    if(action == press_action) {
+        levels.buttons |= bit;
+        pending.buttons_pressed |= bit;
+    } else if(action == release_action) {
+        levels.buttons &= ~bit;
+        pending.buttons_released |= bit;
+    }
+}
+
+void InputStateTracker::cursor(double x, double y, uint64_t timestamp) {
+    levels.cursor_x = x;
+    levels.cursor_y = y;
+    levels.timestamp = timestamp;
+    dirty = true;
+    if(predicting) {
+        cursor_predictor.add(timestamp, x, y);
+        levels.cursor_estimate = cursor_predictor.estimate();
+    }
+}
+
+void InputStateTracker::motion(double dx, double dy, uint64_t timestamp) {
+    pending.motion_dx += dx;
+    pending.motion_dy += dy;
+    levels.timestamp = timestamp;
+    dirty = true;
+    if(predicting) {
+        motion_x += dx;
+        motion_y += dy;
+        motion_predictor.add(timestamp, motion_x, motion_y);
+        levels.motion_estimate = motion_predictor.estimate();
+    }
+}
+
+void InputStateTracker::scroll(double dx, double dy, uint64_t timestamp) {
+    pending.scroll_dx += dx;
+    pending.scroll_dy += dy;
+    levels.timestamp = timestamp;
+    dirty = true;
+}
+
+void InputStateTracker::gamepad_connection(int pad, bool connected, uint64_t timestamp) {
+    if(!InputState::valid_gamepad(pad))
+        return;
+    levels.timestamp = timestamp;
+    dirty = true;
+    if(connected) {
+        levels.gamepads_connected |= 1 << pad;
+        return;
+    }
+    levels.gamepads_connected &= ~(1 << pad);
+    // A log may end a pad without releasing it first.
+    auto& g = levels.gamepads[pad];
+    pending.pad_released[pad] |= g.buttons;
+    g.buttons = 0;
+    g.axes = {};
+}
+
+void InputStateTracker::gamepad_button(int pad, int button, int action, uint64_t timestamp) {
+    if(!InputState::valid_gamepad(pad) || !GamepadState::valid_button(button))
+        return;
+    levels.timestamp = timestamp;
+    dirty = true;
+    uint16_t bit = 1 << button;
+    auto& g = levels.gamepads[pad];
+    if(action == press_action) {
+        g.buttons |= bit;
+        pending.pad_pressed[pad] |= bit;
+    } else if(action == release_action) {
+        g.buttons &= ~bit;
+        pending.pad_released[pad] |= bit;
+    }
+}
+
+void InputStateTracker::gamepad_axis(int pad, int axis, float value, uint64_t timestamp) {
+    if(!InputState::valid_gamepad(pad) || axis < 0 || static_cast<size_t>(axis) >= GamepadState::axis_count)
+        return;
+    levels.gamepads[pad].axes[axis] = value;
+    levels.timestamp = timestamp;
+    dirty = true;
+}
+
+void InputStateTracker::release_all(uint64_t timestamp) {
+    bool pads = false;
+    for(auto& g : levels.gamepads)
+        pads |= g.buttons || g.axes != decltype(g.axes){};
+    if(levels.keys.none() && !levels.buttons && !pads)
+        return;
+    pending.keys_released |= levels.keys;
+    pending.buttons_released |= levels.buttons;
+    levels.keys.reset();
+    levels.buttons = 0;
+    for(size_t i = 0; i < InputState::gamepad_count; ++i) {
+        auto& g = levels.gamepads[i];
+        pending.pad_released[i] |= g.buttons;
+        g.buttons = 0;
+        g.axes = {};
+    }
+    levels.timestamp = timestamp;
+    dirty = true;
+}
+
+void InputStateTracker::set_prediction(bool val, const PredictionConfig& config) {
+    predicting = val;
+    cursor_predictor.configure(config);
+    motion_predictor.configure(config);
+    motion_x = motion_y = 0;
+    levels.cursor_estimate = levels.motion_estimate = MotionEstimate{};
+    dirty = true;
+}
+
+bool InputStateTracker::acquire() {
+    if(buffers.acquire())
+        return true;
+    buffers.front().clear_edges();
+    return false;
+}
+
+void InputStateTracker::publish() {
+    if(!dirty)
+        return;
+    Edges edges;
+    for(;;) {
+        auto observed = buffers.observe();
+        // A publication the consumer never acquired is about to be replaced,
+        // so its edges and deltas move into this one.
+        edges = pending;
+        if(!TripleBuffer<InputState>::consumed(observed))
+            edges.merge(published);
+
+        auto& s = buffers.back();
+        s.keys = levels.keys;
+        s.buttons = levels.buttons;
+        s.mods = levels.mods;
+        s.cursor_x = levels.cursor_x;
+        s.cursor_y = levels.cursor_y;
+        s.cursor_estimate = levels.cursor_estimate;
+        s.motion_estimate = levels.motion_estimate;
+        s.timestamp = levels.timestamp;
+        s.sequence = ++levels.sequence;
+        s.keys_pressed = edges.keys_pressed;
+        s.keys_released = edges.keys_released;
+        s.buttons_pressed = edges.buttons_pressed;
+        s.buttons_released = edges.buttons_released;
+        s.motion_dx = edges.motion_dx;
+        s.motion_dy = edges.motion_dy;
+        s.scroll_dx = edges.scroll_dx;
+        s.scroll_dy = edges.scroll_dy;
+        s.gamepads_connected = levels.gamepads_connected;
+        for(size_t i = 0; i < InputState::gamepad_count; ++i) {
+            s.gamepads[i] = levels.gamepads[i];
+            s.gamepads[i].buttons_pressed = edges.pad_pressed[i];
+            s.gamepads[i].buttons_released = edges.pad_released[i];
+        }
+
+        if(buffers.try_publish(observed))
+            break;
+    }
+    published = edges;
+    pending = Edges{};
+    dirty = false;
+}
@@ -0,0 +1,54 @@
+#include <WindowContext/InputStats.hpp>
+
+using namespace io;
+
+const char* io::event_type_name(EventType type) {
+    switch(type) {
+    case EventType::key_input: return "key_input";
+    case EventType::cursor_position: return "cursor_position";
+    case EventType::mouse_movement: return "mouse_movement";
+    case EventType::mouse_input: return "mouse_input";
+    case EventType::window_resize: return "window_resize";
+    case EventType::character: return "character";
+    case EventType::scroll_input: return "scroll_input";
+    case EventType::gamepad_connection: return "gamepad_connection";
+    case EventType::gamepad_button: return "gamepad_button";
+    case EventType::gamepad_axis: return "gamepad_axis";
+    default: return "unknown";
+    }
+}
+
+namespace {
+
+const char* affinity_name(ListenerAffinity affinity) {
+    switch(affinity) {
+    case ListenerAffinity::inline_: return "inline";
+    case ListenerAffinity::executor: return "executor";
+    default: return "main_thread";
+    }
+}
+
+}
+
+void io::write_stats(std::ostream& out, const InputStats& s) {
+    out << "input stats at " << s.timestamp << ": " << s.wakeups << " wakeups, "
+        << s.wakeups_per_second << "/s; queue " << s.queue.size << "/" << s.queue.capacity
+        << ", high watermark " << s.queue.high_watermark << ", dropped " << s.queue.dropped << "\n";
+    for(size_t t = 0; t < event_type_count; ++t) {
+        auto& c = s.types[t];
+        if(!c.received && !c.unfocused && !c.delivered)
+            continue;
+        out << "  " << event_type_name(static_cast<EventType>(t)) << ": received " << c.received
+            << ", filtered " << c.filtered << ", unfocused " << c.unfocused
+            << ", delivered " << c.delivered << "\n";
+    }
+    for(auto& l : s.listeners) {
+        out << "  listener " << event_type_name(l.token.type) << "#" << l.token.id
+            << " (" << affinity_name(l.affinity) << "): " << l.calls << " calls, "
+            << l.total_ns << " ns total, " << l.max_ns << " ns max\n";
+    }
+    for(auto& q : s.listener_queues) {
+        out << "  queue " << event_type_name(q.token.type) << "#" << q.token.id << ": depth " << q.depth
+            << ", high watermark " << q.high_watermark << ", delivered " << q.delivered << "\n";
+    }
+}
@@ -0,0 +1,121 @@
+#include <WindowContext/MotionPredictor.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace io;
+
+namespace {
+
+constexpr double two_pi = 6.283185307179586;
+
+// Smoothing factor of a first-order low-pass at `cutoff` Hz over `dt` seconds.
+double alpha(double cutoff, double dt) {
+    return 1.0 / (1.0 + 1.0 / (two_pi * cutoff * dt));
+}
+
+}
+
+MotionPredictor::MotionPredictor(const PredictionConfig& config) {
+    configure(config);
+}
+
+void MotionPredictor::validate(const PredictionConfig& c) {
+    if(!(c.min_cutoff > 0) || !(c.derivative_cutoff > 0) || !(c.beta >= 0) || !c.fit_window_ns)
+        throw std::invalid_argument("Prediction cutoffs and fit window must be positive, beta non-negative");
+}
+
+void MotionPredictor::configure(const PredictionConfig& c) {
+    validate(c);
+    config = c;
+    reset();
+}
+
+void MotionPredictor::reset() {
+    head = count = 0;
+    dx = dy = 0;
+    current = MotionEstimate{};
+}
+
+void MotionPredictor::add(uint64_t timestamp, double x, double y) {
+    if(count && timestamp > sample(0).timestamp + config.max_horizon_ns)
+        reset();
+
+    Sample s{timestamp, x, y, 0, 0};
+    double dt = 0;
+    if(count) {
+        auto& prev = sample(0);
+        // Samples sharing a timestamp only move the position.
+        s.timestamp = std::max(timestamp, prev.timestamp);
+        dt = (s.timestamp - prev.timestamp) * 1e-9;
+        if(dt > 0) {
+            s.vx = (x - prev.x) / dt;
+            s.vy = (y - prev.y) / dt;
+        } else {
+            s.vx = prev.vx;
+            s.vy = prev.vy;
+        }
+    }
+    ring[head] = s;
+    head = (head + 1) % history_size;
+    count = std::min(count + 1, history_size);
+
+    current.timestamp = s.timestamp;
+    current.last_x = x;
+    current.last_y = y;
+    current.max_horizon = config.max_horizon_ns;
+    if(count == 1) {
+        current.x = x;
+        current.y = y;
+        return;
+    }
+    if(config.filter == PredictionFilter::one_euro)
+        one_euro(s, dt);
+    else
+        linear_fit();
+}
+
+void MotionPredictor::one_euro(const Sample& s, double dt) {
+    if(dt <= 0)
+        return;
+    double ad = alpha(config.derivative_cutoff, dt);
+    dx += ad * ((s.x - current.x) / dt - dx);
+    dy += ad * ((s.y - current.y) / dt - dy);
+    double a = alpha(config.min_cutoff + config.beta * std::hypot(dx, dy), dt);
+    current.x += a * (s.x - current.x);
+    current.y += a * (s.y - current.y);
+    current.vx = dx;
+    current.vy = dy;
+}
+
+void MotionPredictor::linear_fit() {
+    // Times relative to the newest sample and positions relative to it keep
+    // the sums small however far relative motion has accumulated.
+    auto& newest = sample(0);
+    double n = 0, st = 0, stt = 0, sx = 0, stx = 0, sy = 0, sty = 0;
+    for(size_t age = 0; age < count; ++age) {
+        auto& s = sample(age);
+        if(newest.timestamp - s.timestamp > config.fit_window_ns)
+            break;
+        double t = -double(newest.timestamp - s.timestamp) * 1e-9;
+        double x = s.x - newest.x, y = s.y - newest.y;
+        n += 1;
+        st += t;
+        stt += t * t;
+        sx += x;
+        stx += t * x;
+        sy += y;
+        sty += t * y;
+    }
+    double denom = n * stt - st * st;
+    if(n < 2 || denom <= 0) {
+        current.x = newest.x;
+        current.y = newest.y;
+        current.vx = current.vy = 0;
+        return;
+    }
+    current.vx = (n * stx - st * sx) / denom;
+    current.vy = (n * sty - st * sy) / denom;
+    current.x = newest.x + (sx - current.vx * st) / n;
+    current.y = newest.y + (sy - current.vy * st) / n;
+}
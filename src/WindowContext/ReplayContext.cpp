@@ -0,0 +1,63 @@
+#include <WindowContext/ReplayContext.hpp>
+#include <thread>
+
+using namespace io;
+
+ReplayContext::ReplayContext(const std::string& path, ReplaySpeed speed, size_t event_queue_capacity)
+    : WindowContextBase(event_queue_capacity)
+    , reader(path)
+    , speed(speed) {}
+
+void ReplayContext::feed() {
+    auto now = monotonic_ns();
+    if(!replay_start)
+        replay_start = now;
+    auto log_start = reader.get_start_timestamp();
+
+    auto stats = events.get_event_queue_stats();
+    size_t budget = stats.capacity - stats.size;
+    while(budget) {
+        if(!has_pending) {
+            if(!reader.next(pending)) {
+                finished = true;
+                break;
+            }
+            has_pending = true;
+        }
+        auto offset = pending.timestamp - log_start;
+        if(speed == ReplaySpeed::recorded && offset > now - replay_start)
+            break;
+
+        auto e = pending;
+        e.timestamp = replay_start + offset;
+        if(e.type == EventType::window_resize) {
+            width = e.size.width;
+            height = e.size.height;
+        }
+        events.push_stamped(e);
+        has_pending = false;
+        ++replayed;
+        --budget;
+    }
+    events.publish_state();
+}
+
+bool ReplayContext::update() {
+    if(speed == ReplaySpeed::recorded) {
+        if(auto deadline = next_frame_deadline())
+            std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(deadline)));
+    }
+    if(!finished)
+        feed();
+    events.count_wakeup();
+    drain_events();
+    return !finished;
+}
+
+void ReplayContext::restart() {
+    reader.rewind();
+    replay_start = 0;
+    has_pending = false;
+    finished = false;
+    replayed = 0;
+}
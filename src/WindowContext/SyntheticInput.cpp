@@ -0,0 +1,100 @@
+#include <WindowContext/SyntheticInput.hpp>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+using namespace io;
+
+namespace {
+
+uint64_t period_ns(double rate_hz) {
+    if(!(rate_hz > 0))
+        throw std::invalid_argument("Generator rate must be positive");
+    return std::max<uint64_t>(1, static_cast<uint64_t>(1e9 / rate_hz));
+}
+
+uint32_t xorshift(uint32_t& s) {
+    s ^= s << 13;
+    s ^= s >> 17;
+    s ^= s << 5;
+    return s;
+}
+
+InputEvent stamped(InputEvent e, uint64_t t) {
+    e.timestamp = t;
+    return e;
+}
+
+}
+
+TypingGenerator::TypingGenerator(double chars_per_second, size_t burst_length,
+                                 uint64_t pause_ns, uint32_t seed)
+    : interval(period_ns(chars_per_second))
+    , pause(pause_ns)
+    , burst_length(std::max<size_t>(1, burst_length))
+    , rng(seed ? seed : 1) {}
+
+void TypingGenerator::generate(uint64_t now, const InputEventCallback& emit) {
+    if(!next_due) {
+        next_due = now;
+        return;
+    }
+    for(;;) {
+        if(held_key >= 0) {
+            if(release_due > now)
+                return;
+            emit(stamped(InputEvent::make_key_input(held_key, GLFW_RELEASE, 0), release_due));
+            held_key = -1;
+        }
+        if(next_due > now)
+            return;
+        int letter = xorshift(rng) % 26;
+        emit(stamped(InputEvent::make_key_input(GLFW_KEY_A + letter, GLFW_PRESS, 0), next_due));
+        emit(stamped(InputEvent::make_character('a' + letter), next_due));
+        // Halfway to the next press keeps the timestamps in order.
+        uint64_t gap = ++typed % burst_length ? interval : pause;
+        held_key = GLFW_KEY_A + letter;
+        release_due = next_due + gap / 2;
+        next_due += gap;
+    }
+}
+
+MouseGenerator::MouseGenerator(double rate_hz, double radius, double revolutions_per_second,
+                               double center_x, double center_y)
+    : interval(period_ns(rate_hz))
+    , radius(radius)
+    , radians_per_sample(6.283185307179586 * revolutions_per_second / rate_hz)
+    , center_x(center_x)
+    , center_y(center_y) {}
+
+void MouseGenerator::generate(uint64_t now, const InputEventCallback& emit) {
+    if(!next_due) {
+        next_due = now;
+        return;
+    }
+    for(; next_due <= now; next_due += interval, ++samples) {
+        double a = samples * radians_per_sample;
+        emit(stamped(InputEvent::make_cursor_position(center_x + radius * std::cos(a),
+                                                      center_y + radius * std::sin(a)), next_due));
+    }
+}
+
+ResizeStormGenerator::ResizeStormGenerator(double rate_hz, int min_width, int min_height,
+                                           int max_width, int max_height, uint32_t seed)
+    : interval(period_ns(rate_hz))
+    , min_width(min_width), min_height(min_height)
+    , max_width(std::max(min_width, max_width)), max_height(std::max(min_height, max_height))
+    , rng(seed ? seed : 1) {}
+
+void ResizeStormGenerator::generate(uint64_t now, const InputEventCallback& emit) {
+    if(!next_due) {
+        next_due = now;
+        return;
+    }
+    for(; next_due <= now; next_due += interval) {
+        int w = min_width + xorshift(rng) % (max_width - min_width + 1);
+        int h = min_height + xorshift(rng) % (max_height - min_height + 1);
+        emit(stamped(InputEvent::make_window_resize(w, h), next_due));
+    }
+}
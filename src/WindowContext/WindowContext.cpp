@@ -0,0 +1,44 @@
+#include <WindowContext/WindowContext.hpp>
+#include <WindowContext/GLFWContext.hpp>
+#include <WindowContext/HeadlessContext.hpp>
+#include <mutex>
+#include <stdexcept>
+
+using namespace io;
+
+std::unique_ptr<IWindowContext> io::make_window_context(WindowBackend backend) {
+    switch(backend) {
+    case WindowBackend::glfw:
+        return std::make_unique<GLFWContext>();
+    case WindowBackend::headless:
+        return std::make_unique<HeadlessContext>();
+    }
+    throw std::invalid_argument("Unknown window backend");
+}
+
+IWindowContext& io::get_window_context(WindowBackend backend) {
+    static std::mutex mutex;
+    static IWindowContext* context{nullptr};
+    static WindowBackend selected;
+
+    std::lock_guard lock(mutex);
+    if(context) {
+        if(backend != selected)
+            throw std::runtime_error("Window context already created with another backend");
+        return *context;
+    }
+    switch(backend) {
+    case WindowBackend::glfw: {
+        static GLFWContext glfw;
+        context = &glfw;
+        break;
+    }
+    case WindowBackend::headless: {
+        static HeadlessContext headless;
+        context = &headless;
+        break;
+    }
+    }
+    selected = backend;
+    return *context;
+}
@@ -0,0 +1,194 @@
+#include <WindowContext/WindowContextBase.hpp>
+#include <Text/Utf.hpp>
+
+using namespace io;
+
+namespace {
+
+void set_slot(EventDispatcher& events, EventType type, bool enabled, EventHandler handler) {
+    events.set_slot(type, enabled ? std::move(handler) : nullptr);
+}
+
+template<typename T>
+void set_slot(EventDispatcher& events, EventType type, T fn) {
+    events.set_slot(type, fn ? SlotCallback(std::move(fn)) : SlotCallback());
+}
+
+}
+
+WindowContextBase::WindowContextBase(size_t event_queue_capacity)
+    : events(event_queue_capacity) {}
+
+void WindowContextBase::set_key_input_listener(IKeyInputListener* il) {
+    set_slot(events, EventType::key_input, il, [il](const InputEvent& e) {
+        il->serve_key_input(e.key.key, e.key.action, e.key.mods);
+        return false;
+    });
+}
+void WindowContextBase::set_cursor_position_listener(ICursorPositionListener* pl) {
+    set_slot(events, EventType::cursor_position, pl, [pl](const InputEvent& e) {
+        pl->serve_cursor_position(e.position.x, e.position.y);
+        return false;
+    });
+}
+void WindowContextBase::set_mouse_movement_listener(IMouseMovementListener* ml) {
+    set_slot(events, EventType::mouse_movement, ml, [ml](const InputEvent& e) {
+        ml->serve_mouse_movement(e.position.x, e.position.y);
+        return false;
+    });
+}
+void WindowContextBase::set_mouse_input_listener(IMouseInputListener* ml) {
+    set_slot(events, EventType::mouse_input, ml, [ml](const InputEvent& e) {
+        ml->serve_mouse_input(e.button.button, e.button.action, e.button.mods);
+        return false;
+    });
+}
+void WindowContextBase::set_window_resized_listener(IWindowResizeListener* rl) {
+    set_slot(events, EventType::window_resize, rl, [rl](const InputEvent& e) {
+        rl->serve_window_resized(e.size.width, e.size.height);
+        return false;
+    });
+}
+void WindowContextBase::set_character_listener(ICharacterInputListener* cl) {
+    events.set_characters_slot(
+        CharactersInputCallback::bind<&ICharacterInputListener::serve_characters>(cl));
+}
+void WindowContextBase::set_scroll_input_listener(IScrollIuputListener *sl) {
+    set_slot(events, EventType::scroll_input, sl, [sl](const InputEvent& e) {
+        sl->serve_scroll_input(e.position.x, e.position.y);
+        return false;
+    });
+}
+void WindowContextBase::set_input_event_listener(IInputEventListener* el) {
+    events.set_input_event_callback(
+        InputEventCallback::bind<&IInputEventListener::serve_input_event>(el));
+}
+
+void WindowContextBase::set_key_input_callback(KeyInputCallback fn) {
+    set_slot(events, EventType::key_input, std::move(fn));
+}
+void WindowContextBase::set_cursor_position_callback(CursorPositionCallback fn) {
+    set_slot(events, EventType::cursor_position, std::move(fn));
+}
+void WindowContextBase::set_mouse_movement_callback(MouseMovementCallback fn) {
+    set_slot(events, EventType::mouse_movement, std::move(fn));
+}
+void WindowContextBase::set_mouse_input_callback(MouseInputCallback fn) {
+    set_slot(events, EventType::mouse_input, std::move(fn));
+}
+void WindowContextBase::set_window_resized_callback(WindowResizeCallback fn) {
+    set_slot(events, EventType::window_resize, std::move(fn));
+}
+void WindowContextBase::set_character_callback(CharacterInputCallback fn) {
+    events.set_characters_slot(std::move(fn));
+}
+void WindowContextBase::set_characters_callback(CharactersInputCallback fn) {
+    events.set_characters_slot(std::move(fn));
+}
+void WindowContextBase::set_scroll_input_callback(ScrollInputCallback fn) {
+    set_slot(events, EventType::scroll_input, std::move(fn));
+}
+void WindowContextBase::set_input_event_callback(InputEventCallback fn) {
+    events.set_input_event_callback(std::move(fn));
+}
+
+void WindowContextBase::set_drain_callback(DrainCallback fn) {
+    events.set_drain_callback(std::move(fn));
+}
+
+uint64_t WindowContextBase::add_drain_callback(DrainCallback fn) {
+    return events.add_drain_callback(std::move(fn));
+}
+
+bool WindowContextBase::remove_drain_callback(uint64_t id) {
+    return events.remove_drain_callback(id);
+}
+
+SubscriptionToken WindowContextBase::subscribe(EventType type, EventHandler handler, int priority,
+                                               ListenerAffinity affinity, const EventFilter& filter) {
+    return events.subscribe(type, std::move(handler), priority, affinity, filter);
+}
+
+bool WindowContextBase::unsubscribe(SubscriptionToken token) {
+    return events.unsubscribe(token);
+}
+
+std::vector<ListenerQueueStats> WindowContextBase::get_listener_queue_stats() {
+    return events.get_listener_queue_stats();
+}
+
+void WindowContextBase::start_recording(const std::string& path) {
+    events.start_recording(path);
+}
+
+void WindowContextBase::stop_recording() {
+    events.stop_recording();
+}
+
+size_t WindowContextBase::paste_text(const std::string& utf8) {
+    std::vector<uint32_t> codepoints(utf8.size());
+    codepoints.resize(utf8_to_utf32(utf8.data(), utf8.size(), codepoints.data()));
+    events.deliver_characters(codepoints.data(), codepoints.size());
+    return codepoints.size();
+}
+
+void WindowContextBase::set_motion_coalescing(bool val) {
+    events.set_motion_coalescing(val);
+}
+
+void WindowContextBase::set_frame_interval(uint64_t interval_ns) {
+    frame_interval = interval_ns;
+    frame_deadline = 0;
+}
+
+void WindowContextBase::set_gamepad_response(const GamepadResponse& sticks, const GamepadResponse& triggers) {
+    gamepads.set_stick_response(sticks);
+    gamepads.set_trigger_response(triggers);
+}
+
+uint64_t WindowContextBase::next_frame_deadline() {
+    if(!frame_interval)
+        return 0;
+    auto now = monotonic_ns();
+    if(!frame_deadline)
+        frame_deadline = now + frame_interval;
+    else if(frame_deadline <= now)
+        frame_deadline += ((now - frame_deadline) / frame_interval + 1) * frame_interval;
+    return frame_deadline;
+}
+
+size_t WindowContextBase::drain_events() {
+    return events.drain();
+}
+
+void WindowContextBase::set_state_tracking(bool val) {
+    events.set_state_tracking(val);
+}
+
+const InputState& WindowContextBase::get_input_state() {
+    return events.get_input_state();
+}
+
+void WindowContextBase::set_motion_prediction(bool val, const PredictionConfig& config) {
+    events.set_motion_prediction(val, config);
+}
+
+EventQueueStats WindowContextBase::get_event_queue_stats() {
+    return events.get_event_queue_stats();
+}
+
+LatencySnapshot WindowContextBase::get_latency_snapshot() {
+    return events.get_latency_snapshot();
+}
+
+void WindowContextBase::reset_latency_histograms() {
+    events.reset_latency_histograms();
+}
+
+InputStats WindowContextBase::stats() {
+    return events.stats();
+}
+
+void WindowContextBase::set_stats_sink(StatsSink sink, uint64_t period_ns) {
+    events.set_stats_sink(std::move(sink), period_ns);
+}
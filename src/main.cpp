@@ -1,59 +1,28 @@
 #include <iostream>
-#include <list>
-#include <unordered_map>
+#include <vector>
 #include <functional>
+#include <cstring>
 
 #include <GLFW/glfw3.h>
-#include <unicode/unistr.h>
 
-#include "../include/WindowContext/GLFWContext.hpp"
+#include "../include/WindowContext/WindowContext.hpp"
+#include "../include/WindowContext/HeadlessContext.hpp"
+#include "../include/WindowContext/ActionMap.hpp"
+#include "../include/Text/TerminalTextRenderer.hpp"
 using namespace io;
 
-class KeyInputListenerBase : public IKeyInputListener {
-    IKeyInputListener* next{nullptr};
-    virtual bool _serve(int key, int action, int mods) = 0;
-public:
-    void serve_key_input(int key, int action, int mods) override {
-        if(!_serve(key, action, mods) && next)
-            next->serve_key_input(key, action, mods);
-    }
-    void set_next(IKeyInputListener* il) {
-        next = il;
-    }
-};
-
-class TextEdit : public ICharacterInputListener {
-    std::list<uint32_t> characters;
-    std::list<uint32_t>::iterator cursor{characters.end()};
+class TextField : public ICharacterInputListener {
+    io::TextEdit text;
+    TerminalTextRenderer renderer;
     std::atomic_bool active{false};
-
-    void print() {
-        using It = std::list<uint32_t>::iterator;
-        auto get_str = [](It begin, It end) {
-            icu::UnicodeString uni_str;
-            std::for_each(begin, end, [&uni_str](auto c){ uni_str.append((UChar32)c); });
-
-            std::string str;
-            uni_str.toUTF8String(str);
-            return str;
-        };
-
-        std::cout << get_str(characters.begin(), cursor);
-
-        if(cursor == characters.end()) {
-            std::cout << "\u001b[7m \u001b[0m" << std::endl;
-            return;
-        }
-        std::cout << "\u001b[7m" << get_str(cursor, std::next(cursor)) << "\u001b[0m";
-        std::cout << get_str(std::next(cursor), characters.end()) << std::endl;
-    }
 public:
-    TextEdit() {}
-
     void insert(uint32_t codepoint) {
-        characters.insert(cursor, codepoint);
-
-        print();
+        text.insert(codepoint);
+    }
+    // Draws whatever changed since the previous frame.
+    void render() {
+        if(is_active())
+            renderer.render(text);
     }
 public:
     bool is_active() {
@@ -61,43 +30,37 @@ public:
     }
 
     void set_active(bool val) {
+        if(val)
+            renderer.invalidate();
         active = val;
     }
 
-    void delete_() {
-        if(cursor == characters.end()) return;
-        cursor = characters.erase(cursor);
-
-        print();
-    }
-    void backspace() {
-        if(cursor == characters.begin()) return;
-        --cursor;
-        delete_();
-    }
-    void move_left() {
-        if(cursor == characters.begin()) return;
-        --cursor;
-
-        print();
-    }
-    void move_right() {
-        if(cursor == characters.end()) return;
-        ++cursor;
-
-        print();
-    }
+    void delete_() { text.delete_(); }
+    void backspace() { text.backspace(); }
+    void move_left() { text.move_left(); }
+    void move_right() { text.move_right(); }
+    void move_word_left() { text.move_word_left(); }
+    void move_word_right() { text.move_word_right(); }
+    void move_line_start() { text.move_line_start(); }
+    void move_line_end() { text.move_line_end(); }
+    void move_line_up() { text.move_line_up(); }
+    void move_line_down() { text.move_line_down(); }
 
     void serve_character(uint32_t codepoint) override {
         if(is_active())
             insert(codepoint);
     }
+    void serve_characters(const uint32_t* codepoints, size_t count) override {
+        if(is_active())
+            text.insert(codepoints, count);
+    }
 };
 
-class KeyInputListenerUi : public KeyInputListenerBase {
-    TextEdit& te;
-
-    bool _serve(int key, int action, int mods) override {
+class KeyInputListenerUi {
+    IWindowContext& input;
+    TextField& te;
+public:
+    bool serve(int key, int action, int mods) {
         if(te.is_active()) {
             if(action != GLFW_PRESS && action != GLFW_REPEAT)
                 return true;
@@ -112,10 +75,26 @@ class KeyInputListenerUi : public KeyInputListenerBase {
                 te.delete_();
                 break;
             case GLFW_KEY_LEFT:
-                te.move_left();
+                mods & GLFW_MOD_CONTROL ? te.move_word_left() : te.move_left();
                 break;
             case GLFW_KEY_RIGHT:
-                te.move_right();
+                mods & GLFW_MOD_CONTROL ? te.move_word_right() : te.move_right();
+                break;
+            case GLFW_KEY_HOME:
+                te.move_line_start();
+                break;
+            case GLFW_KEY_END:
+                te.move_line_end();
+                break;
+            case GLFW_KEY_UP:
+                te.move_line_up();
+                break;
+            case GLFW_KEY_DOWN:
+                te.move_line_down();
+                break;
+            case GLFW_KEY_V:
+                if(mods & GLFW_MOD_CONTROL)
+                    input.paste_clipboard();
                 break;
             }
             return true;
@@ -126,46 +105,34 @@ class KeyInputListenerUi : public KeyInputListenerBase {
         }
         return false;
     }
-public:
-    KeyInputListenerUi(TextEdit& te) : te(te) {}
+    KeyInputListenerUi(IWindowContext& input, TextField& te) : input(input), te(te) {}
     void set_text_mode(bool val) {
-        io::GLFWContext::get().set_sticky_keys(!val);
+        input.set_sticky_keys(!val);
         te.set_active(val);
         val ? std::cout << "entering text mode" << std::endl
-            : std::cout << "exiting text mode" << std::endl;
+            : std::cout << std::endl << "exiting text mode" << std::endl;
     }
 };
 
-class KeyInputListenerGameObject : public KeyInputListenerBase {
+class KeyInputListenerGameObject {
+    ActionMap actions;
+    std::vector<std::function<void()>> callbacks;
 public:
-    std::unordered_map<size_t, std::function<void()>> callbacks;
-
-    size_t hash(int key, int action = GLFW_PRESS, int mods = 0) {
-        size_t h = key;
-        h <<= 16;
-        h |= action;
-        h <<= 16;
-        h |= mods;
-        return h;
-    }
-
     KeyInputListenerGameObject() {
-        callbacks[hash(GLFW_KEY_W)] = [](){std::cout << "Forward" << std::endl;};
-        callbacks[hash(GLFW_KEY_S)] = [](){std::cout << "Backward" << std::endl;};
-        callbacks[hash(GLFW_KEY_A)] = [](){std::cout << "Left" << std::endl;};
-        callbacks[hash(GLFW_KEY_D)] = [](){std::cout << "Right" << std::endl;};
+        add_callback(GLFW_KEY_W, GLFW_PRESS, 0, [](){std::cout << "Forward" << std::endl;});
+        add_callback(GLFW_KEY_S, GLFW_PRESS, 0, [](){std::cout << "Backward" << std::endl;});
+        add_callback(GLFW_KEY_A, GLFW_PRESS, 0, [](){std::cout << "Left" << std::endl;});
+        add_callback(GLFW_KEY_D, GLFW_PRESS, 0, [](){std::cout << "Right" << std::endl;});
     }
 
     void add_callback(int key, int action, int mods, std::function<void()> fn) {
-        callbacks[hash(key, action, mods)] = std::move(fn);
+        ActionId id = callbacks.size();
+        callbacks.push_back(std::move(fn));
+        actions.bind(key, 1 << action, id, mods, 0xff);
     }
 
-    bool _serve(int key, int action, int mods) override {
-        if(auto it = callbacks.find(hash(key, action, mods)); it != callbacks.end()) {
-            it->second();
-            return true;
-        }
-        return false;
+    bool serve(const InputEvent& e) {
+        return actions.process(e, [this](ActionId id, int) { callbacks[id](); });
     }
 };
 
@@ -183,27 +150,34 @@ public:
     }
 };
 
-int main()
+int main(int argc, char** argv)
 {
-    TextEdit te;
-    KeyInputListenerUi input_listener_ui(te);
+    bool headless = argc > 1 && std::strcmp(argv[1], "--headless") == 0;
+    auto& input = io::get_window_context(headless ? WindowBackend::headless : WindowBackend::glfw);
+    if(headless)
+        static_cast<HeadlessContext&>(input).add_generator(std::make_unique<TypingGenerator>());
+
+    TextField te;
+    KeyInputListenerUi input_listener_ui(input, te);
     KeyInputListenerGameObject input_listener_go;
-    input_listener_ui.set_next(&input_listener_go);
 
     CursorPositionListener cpl;
     MouseInputListener mml;
 
-    auto& input = io::GLFWContext::get();
-    input.set_key_input_listener(&input_listener_ui);
+    input.subscribe(EventType::key_input, [&input_listener_ui](const InputEvent& e) {
+        return input_listener_ui.serve(e.key.key, e.key.action, e.key.mods);
+    }, 10);
+    input.subscribe(EventType::key_input, [&input_listener_go](const InputEvent& e) {
+        return input_listener_go.serve(e);
+    });
     input.set_cursor_position_listener(&cpl);
     input.set_mouse_movement_listener(&mml);
     input.set_character_listener(&te);
+    input.set_motion_coalescing(true);
 
     bool cursor = false;
     input_listener_go.add_callback(GLFW_KEY_T, GLFW_PRESS, 0, [&input, &cursor](){cursor = !cursor; input.set_cursor_mode(cursor);});
 
     while (input.update())
-    {
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-    }
+        te.render();
 }